@@ -1,6 +1,5 @@
-layout (location=0) in vec3 InPos;
-layout (location=1) in vec3 InNorm;
-layout (location=2) in vec4 InColor;
+layout (location=0) in uvec4 InPosNormal;
+layout (location=1) in uint InVoxel;
 
 out vec3 VSNormal;
 out vec3 VSLightDir;
@@ -11,13 +10,29 @@ uniform mat4 viewMat;
 uniform mat4 perspMat;
 uniform vec4 playerPos;
 
+// Colors of voxels, indexed by VoxelType. Filled by Renderer from VoxelDB.
+uniform vec3 voxelPalette[16];
+
+// Normals indexed by PackedVertex normal index
+const vec3 NORMALS[6] = vec3[6](
+    vec3( 1.0, 0.0, 0.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3( 0.0, 1.0, 0.0),
+    vec3( 0.0,-1.0, 0.0),
+    vec3( 0.0, 0.0, 1.0),
+    vec3( 0.0, 0.0,-1.0)
+);
+
 void main()
 {
+    // Packed positions are voxel corners, while voxel centers lie on integer coordinates
+    vec3 pos = vec3(InPosNormal.xyz) - vec3(0.5);
+
     mat4 viewPerspMat = perspMat * viewMat;
-    vec4 worldPos = worldMat * vec4(InPos, 1.0);
+    vec4 worldPos = worldMat * vec4(pos, 1.0);
     gl_Position = viewPerspMat * worldPos;
 
-    VSNormal = vec3(viewMat * vec4(InNorm, 0.0));
+    VSNormal = vec3(viewMat * vec4(NORMALS[InPosNormal.w], 0.0));
     VSLightDir = vec3(viewMat * (worldPos - playerPos));
-    VSColor = InColor;
+    VSColor = vec4(voxelPalette[InVoxel], 1.0);
 }
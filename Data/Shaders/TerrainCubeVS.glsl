@@ -0,0 +1,69 @@
+layout (location=0) in uvec4 InCornerNormal;
+layout (location=1) in uvec4 InPosFaces;
+layout (location=2) in uint InVoxel;
+
+out vec3 VSNormal;
+out vec3 VSLightDir;
+out vec4 VSColor;
+
+uniform mat4 worldMat;
+uniform mat4 viewMat;
+uniform mat4 perspMat;
+uniform vec4 playerPos;
+
+// Colors of voxels, indexed by VoxelType. Filled by Renderer from VoxelDB.
+uniform vec3 voxelPalette[16];
+
+// Normals indexed by PackedVertex normal index, the same as in MainVS.glsl
+const vec3 NORMALS[6] = vec3[6](
+    vec3( 1.0, 0.0, 0.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3( 0.0, 1.0, 0.0),
+    vec3( 0.0,-1.0, 0.0),
+    vec3( 0.0, 0.0, 1.0),
+    vec3( 0.0, 0.0,-1.0)
+);
+
+// Face of the voxel, which lies in direction of the normal. Y normals point inside the voxel.
+const vec3 FACE_DIRS[6] = vec3[6](
+    vec3( 1.0, 0.0, 0.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3( 0.0,-1.0, 0.0),
+    vec3( 0.0, 1.0, 0.0),
+    vec3( 0.0, 0.0, 1.0),
+    vec3( 0.0, 0.0,-1.0)
+);
+
+// ChunkMesher::FACE_* bits of these faces
+const uint FACE_BITS[6] = uint[6](0x01u, 0x02u, 0x08u, 0x04u, 0x10u, 0x20u);
+
+void main()
+{
+    uint normal = InCornerNormal.w;
+    vec3 center = vec3(InPosFaces.xyz);
+    vec4 worldFace = worldMat * vec4(center + 0.5 * FACE_DIRS[normal], 1.0);
+    vec3 worldFaceDir = vec3(worldMat * vec4(FACE_DIRS[normal], 0.0));
+
+    // Faces hidden by neighbours, or turned away from the camera, collapse into a single point
+    // outside of the clip volume and are never rasterized
+    if ((InPosFaces.w & FACE_BITS[normal]) == 0u ||
+        dot(worldFaceDir, playerPos.xyz - worldFace.xyz) <= 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        VSNormal = vec3(0.0);
+        VSLightDir = vec3(0.0);
+        VSColor = vec4(0.0);
+        return;
+    }
+
+    // Cube corners are voxel corners, while voxel centers lie on integer coordinates
+    vec3 pos = center + vec3(InCornerNormal.xyz) - vec3(0.5);
+
+    mat4 viewPerspMat = perspMat * viewMat;
+    vec4 worldPos = worldMat * vec4(pos, 1.0);
+    gl_Position = viewPerspMat * worldPos;
+
+    VSNormal = vec3(viewMat * vec4(NORMALS[normal], 0.0));
+    VSLightDir = vec3(viewMat * (worldPos - playerPos));
+    VSColor = vec4(voxelPalette[InVoxel], 1.0);
+}
@@ -34,4 +34,21 @@ std::string GetLastErrorString();
  */
 bool IsNumeric(char const *string);
 
+/**
+ * Instruction set extensions, which can be queried with IsCPUFeatureSupported().
+ */
+enum class CPUFeature: unsigned char
+{
+    SSE41,  ///< SSE 4.1
+    AVX2,   ///< AVX2, including OS support for saving YMM registers.
+};
+
+/**
+ * Check if CPU running the application supports given feature.
+ *
+ * @param feature Feature to check.
+ * @return True if @p feature can be used. False otherwise.
+ */
+bool IsCPUFeatureSupported(CPUFeature feature);
+
 #endif // __COMMON_COMMON_HPP__
\ No newline at end of file
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Data compression utility definitions
+ */
+
+#include "Compression.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 0xFFFF;
+const unsigned int HASH_LOG = 12;
+const unsigned int HASH_SIZE = 1 << HASH_LOG;
+const unsigned char TOKEN_MASK = 0xF;
+
+uint32_t Read32(const unsigned char* ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence)
+{
+    // Knuth's multiplicative hash - top bits are the best mixed ones
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Write length exceeding token's 4 bits as a sequence of 255-valued bytes and a remainder
+void WriteLength(size_t length, std::vector<unsigned char>& dst)
+{
+    while (length >= 0xFF)
+    {
+        dst.push_back(0xFF);
+        length -= 0xFF;
+    }
+    dst.push_back(static_cast<unsigned char>(length));
+}
+
+bool ReadLength(const unsigned char*& src, const unsigned char* srcEnd, size_t& length)
+{
+    unsigned char byte;
+    do
+    {
+        if (src == srcEnd)
+            return false;
+        byte = *src++;
+        length += byte;
+    } while (byte == 0xFF);
+
+    return true;
+}
+
+void WriteSequence(const unsigned char* literals, size_t literalCount, size_t offset,
+                   size_t matchLength, std::vector<unsigned char>& dst)
+{
+    size_t literalToken = literalCount < TOKEN_MASK ? literalCount : TOKEN_MASK;
+    size_t matchToken = 0;
+    if (matchLength > 0)
+    {
+        matchLength -= MIN_MATCH;
+        matchToken = matchLength < TOKEN_MASK ? matchLength : TOKEN_MASK;
+    }
+
+    dst.push_back(static_cast<unsigned char>((literalToken << 4) | matchToken));
+    if (literalToken == TOKEN_MASK)
+        WriteLength(literalCount - TOKEN_MASK, dst);
+
+    dst.insert(dst.end(), literals, literals + literalCount);
+
+    // Last sequence in the stream carries literals only
+    if (offset == 0)
+        return;
+
+    dst.push_back(static_cast<unsigned char>(offset & 0xFF));
+    dst.push_back(static_cast<unsigned char>(offset >> 8));
+    if (matchToken == TOKEN_MASK)
+        WriteLength(matchLength - TOKEN_MASK, dst);
+}
+
+} // namespace
+
+namespace Compression {
+
+void LZCompress(const unsigned char* src, size_t srcSize, std::vector<unsigned char>& dst)
+{
+    // Positions are kept +1, so zero marks an empty slot
+    uint32_t hashTable[HASH_SIZE];
+    memset(hashTable, 0, sizeof(hashTable));
+
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (srcSize >= MIN_MATCH && pos <= srcSize - MIN_MATCH)
+    {
+        uint32_t sequence = Read32(src + pos);
+        uint32_t& slot = hashTable[Hash(sequence)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET ||
+            Read32(src + candidate - 1) != sequence)
+        {
+            pos++;
+            continue;
+        }
+
+        candidate--;
+
+        // Extend the match as far as possible
+        size_t matchLength = MIN_MATCH;
+        while (pos + matchLength < srcSize && src[candidate + matchLength] == src[pos + matchLength])
+            matchLength++;
+
+        WriteSequence(src + anchor, pos - anchor, pos - candidate, matchLength, dst);
+
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    // Flush remaining literals (always emitted, so empty input still produces a valid stream)
+    WriteSequence(src + anchor, srcSize - anchor, 0, 0, dst);
+}
+
+bool LZDecompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize)
+{
+    const unsigned char* srcEnd = src + srcSize;
+    size_t out = 0;
+    bool terminated = false;
+
+    while (src < srcEnd)
+    {
+        unsigned char token = *src++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == TOKEN_MASK && !ReadLength(src, srcEnd, literalCount))
+            return false;
+
+        if (literalCount > static_cast<size_t>(srcEnd - src) || literalCount > dstSize - out)
+            return false;
+
+        memcpy(dst + out, src, literalCount);
+        src += literalCount;
+        out += literalCount;
+
+        // Literal-only sequence terminates the stream
+        if (src == srcEnd)
+        {
+            terminated = true;
+            break;
+        }
+
+        if (srcEnd - src < 2)
+            return false;
+
+        size_t offset = src[0] | (src[1] << 8);
+        src += 2;
+
+        size_t matchLength = token & TOKEN_MASK;
+        if (matchLength == TOKEN_MASK && !ReadLength(src, srcEnd, matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > out || matchLength > dstSize - out)
+            return false;
+
+        // Source and destination overlap when offset is shorter than the match, which
+        // encodes a repeating pattern. Copy byte by byte then.
+        unsigned char* matchDst = dst + out;
+        const unsigned char* matchSrc = matchDst - offset;
+        if (offset >= matchLength)
+            memcpy(matchDst, matchSrc, matchLength);
+        else
+            for (size_t i = 0; i < matchLength; ++i)
+                matchDst[i] = matchSrc[i];
+
+        out += matchLength;
+    }
+
+    // Stream cut right after a match would otherwise pass as complete
+    return terminated && out == dstSize;
+}
+
+} // namespace Compression
@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Data compression utility declarations
+ */
+
+#ifndef __COMMON_COMPRESSION_HPP__
+#define __COMMON_COMPRESSION_HPP__
+
+#include <cstddef>
+#include <vector>
+
+namespace Compression {
+
+/**
+ * Compress @p srcSize bytes from @p src with a fast LZ77-class codec.
+ *
+ * @param src     Data to compress.
+ * @param srcSize Size of @p src in bytes.
+ * @param dst     Output buffer. Compressed stream is appended to its current contents.
+ *
+ * The codec is byte-oriented and favors speed over ratio. Stream is a sequence of tokens, each
+ * describing a run of literals followed by a back-reference (offset, length) within a 64 KiB
+ * window, so decompression consists only of plain memory copies.
+ */
+void LZCompress(const unsigned char* src, size_t srcSize, std::vector<unsigned char>& dst);
+
+/**
+ * Decompress data created by LZCompress().
+ *
+ * @param src     Compressed stream.
+ * @param srcSize Size of @p src in bytes.
+ * @param dst     Output buffer, must be able to hold @p dstSize bytes.
+ * @param dstSize Exact size of decompressed data.
+ * @return True on success, false if the stream is corrupted or does not decompress to exactly
+ *         @p dstSize bytes.
+ *
+ * All reads and writes are bounds-checked, so corrupted input will never cause buffer overruns.
+ */
+bool LZDecompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize);
+
+} // namespace Compression
+
+#endif // __COMMON_COMPRESSION_HPP__
@@ -8,6 +8,7 @@
 #define __COMMON_FILESYSTEM_HPP__
 
 #include <string>
+#include <vector>
 
 namespace FS {
 
@@ -44,6 +45,14 @@ bool CreateDir(const std::string& path);
  */
 bool IsDir(const std::string& path);
 
+/**
+ * List regular files inside @p dir.
+ *
+ * @param dir Directory to scan.
+ * @return Names of files (without directory prefix). Empty if @p dir does not exist.
+ */
+std::vector<std::string> ListFiles(const std::string& dir);
+
 } // namespace FS
 
 #endif // __COMMON_FILESYSTEM_HPP__
\ No newline at end of file
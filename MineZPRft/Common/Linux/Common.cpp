@@ -19,3 +19,18 @@ bool IsNumeric(char const *string)
     return std::all_of(string, string + strlen(string),
                        [](unsigned char c) { return ::isdigit(c); });
 }
+
+bool IsCPUFeatureSupported(CPUFeature feature)
+{
+    __builtin_cpu_init();
+
+    switch (feature)
+    {
+    case CPUFeature::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case CPUFeature::AVX2:
+        return __builtin_cpu_supports("avx2");
+    }
+
+    return false;
+}
@@ -12,6 +12,7 @@
 #include <memory>
 #include <iostream>
 #include <unistd.h>
+#include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <cstring>
@@ -100,4 +101,25 @@ bool IsDir(const std::string& path)
     return false;
 }
 
+std::vector<std::string> ListFiles(const std::string& dir)
+{
+    std::vector<std::string> files;
+
+    DIR* dirHandle = ::opendir(dir.c_str());
+    if (!dirHandle)
+        return files;
+
+    struct dirent* entry;
+    while ((entry = ::readdir(dirHandle)) != nullptr)
+    {
+        std::string path = dir + '/' + entry->d_name;
+        struct stat st;
+        if (::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+            files.push_back(entry->d_name);
+    }
+
+    ::closedir(dirHandle);
+    return files;
+}
+
 } // namespace FS
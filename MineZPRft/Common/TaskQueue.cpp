@@ -15,11 +15,10 @@ void TaskQueue<void>::Pop()
         Lock lock(mMutex);
 
         // wait until we have something to process
-        while (mList.empty())
+        while (mList.empty() && mUrgentList.empty())
             mCV.wait(lock);
 
-        task = mList.front();
-        mList.pop_front();
+        task = TakeTask();
     }
 
     // we can unlock here and allow producer to continue calculating
@@ -8,6 +8,7 @@
 #define __COMMON_TASKQUEUE_HPP__
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <list>
 
@@ -44,6 +45,17 @@ public:
      */
     void Push(const TaskType& task);
 
+    /**
+     * Push a task to high-priority lane of the queue.
+     *
+     * @param task Task to be pushed.
+     *
+     * Tasks from this lane are taken before any task pushed with Push(), in FIFO order among
+     * themselves. Meant for work the user waits for, which should not queue up behind
+     * background work.
+     */
+    void PushUrgent(const TaskType& task);
+
     /**
      * Pop a task from top of the queue, call it and return its value.
      *
@@ -63,7 +75,9 @@ public:
     /**
      * Empties the queue, blocking execution until all tasks are completed.
      *
-     * Return type of the task is discarded.
+     * Return type of the task is discarded. Queue is not locked while a task is called, so tasks
+     * pushed in the meantime are processed as well and multiple consumers can empty the queue
+     * in parallel.
      */
     void EmptyWait();
 
@@ -81,7 +95,14 @@ public:
 private:
     typedef std::list<TaskType> QueueType;
 
+    /**
+     * Removes next task from the queue, urgent ones first. Mutex must be locked and the queue
+     * must not be empty.
+     */
+    TaskType TakeTask();
+
     QueueType mList;
+    QueueType mUrgentList;
     std::mutex mMutex;
     std::condition_variable mCV;
 };
@@ -95,6 +116,24 @@ void TaskQueue<T>::Push(const TaskType& task)
     mCV.notify_all();
 }
 
+template <typename T>
+void TaskQueue<T>::PushUrgent(const TaskType& task)
+{
+    Lock lock(mMutex);
+
+    mUrgentList.push_back(task);
+    mCV.notify_all();
+}
+
+template <typename T>
+typename TaskQueue<T>::TaskType TaskQueue<T>::TakeTask()
+{
+    QueueType& list = mUrgentList.empty() ? mList : mUrgentList;
+    TaskType task = list.front();
+    list.pop_front();
+    return task;
+}
+
 template <typename T>
 T TaskQueue<T>::Pop()
 {
@@ -104,11 +143,10 @@ T TaskQueue<T>::Pop()
         Lock lock(mMutex);
 
         // wait until we have something to process
-        while (mList.empty())
+        while (mList.empty() && mUrgentList.empty())
             mCV.wait(lock);
 
-        task = mList.front();
-        mList.pop_front();
+        task = TakeTask();
     }
 
     // we can unlock here and allow producer to continue adding new tasks for us
@@ -123,12 +161,14 @@ void TaskQueue<T>::EmptyWait()
 
     TaskType task;
 
-    // pop tasks until all are processed
-    while (!mList.empty())
+    // pop tasks until all are processed, producer can add new tasks while one is being called
+    while (!mList.empty() || !mUrgentList.empty())
     {
-        task = mList.front();
-        mList.pop_front();
+        task = TakeTask();
+
+        lock.unlock();
         task();
+        lock.lock();
     }
 }
 
@@ -137,13 +177,14 @@ void TaskQueue<T>::Clear()
 {
     Lock lock(mMutex);
     mList.clear();
+    mUrgentList.clear();
 }
 
 template <typename T>
 bool TaskQueue<T>::IsEmpty()
 {
     Lock lock(mMutex);
-    return mList.empty();
+    return mList.empty() && mUrgentList.empty();
 }
 
 // specialization declarations
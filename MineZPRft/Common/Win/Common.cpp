@@ -7,6 +7,7 @@
 #include "../Common.hpp"
 
 #include <Windows.h>
+#include <intrin.h>
 #include <algorithm>
 
 std::string GetLastErrorString()
@@ -23,3 +24,28 @@ bool IsNumeric(char const *string)
     return std::all_of(string, string + strlen(string),
                        [](unsigned char c) { return ::isdigit(c); });
 }
+
+bool IsCPUFeatureSupported(CPUFeature feature)
+{
+    int info[4];
+    __cpuid(info, 1);
+
+    switch (feature)
+    {
+    case CPUFeature::SSE41:
+        return (info[2] & (1 << 19)) != 0;
+    case CPUFeature::AVX2:
+    {
+        // AVX registers must be enabled by OS (OSXSAVE bit and XCR0 state), not only by CPU
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+    }
+
+    return false;
+}
@@ -113,4 +113,23 @@ bool IsDir(const std::string& path)
     return false;
 }
 
+std::vector<std::string> ListFiles(const std::string& dir)
+{
+    std::vector<std::string> files;
+
+    WIN32_FIND_DATA findData;
+    HANDLE findHandle = ::FindFirstFile((dir + "\\*").c_str(), &findData);
+    if (findHandle == INVALID_HANDLE_VALUE)
+        return files;
+
+    do
+    {
+        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            files.push_back(findData.cFileName);
+    } while (::FindNextFile(findHandle, &findData) != 0);
+
+    ::FindClose(findHandle);
+    return files;
+}
+
 } // namespace FS
@@ -38,7 +38,11 @@ GameManager::GameManager()
 
     TerrainDesc td;
     td.visibleRadius = 7;
-    td.useGreedyMeshing = true;
+    td.meshingMethod = MeshingMethod::Greedy;
+    td.lodRadius[0] = 4;
+    td.lodRadius[1] = 6;
+    td.chunkCompression = ChunkCompression::LZ;
+    td.generator = GetWorldGeneratorDesc(WORLD_SEED);
     mTerrain.Init(td);
 }
 
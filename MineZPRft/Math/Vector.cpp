@@ -8,6 +8,7 @@
 #include "Common/Exception.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
 Vector::Vector()
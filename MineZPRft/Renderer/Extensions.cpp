@@ -15,12 +15,18 @@ namespace OGLExt {
 PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
 PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 PFNGLBUFFERDATAPROC glBufferData = nullptr;
+PFNGLBUFFERSUBDATAPROC glBufferSubData = nullptr;
 PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
 
 /// Vertex Attrib Array
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = nullptr;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = nullptr;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray = nullptr;
+PFNGLVERTEXATTRIBIPOINTERPROC glVertexAttribIPointer = nullptr;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = nullptr;
+
+/// Drawing
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced = nullptr;
 
 /// Vertex Array Objects
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = nullptr;
@@ -43,6 +49,7 @@ PFNGLDELETEPROGRAMPROC glDeleteProgram = nullptr;
 PFNGLUSEPROGRAMPROC glUseProgram = nullptr;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = nullptr;
 PFNGLUNIFORM4FPROC glUniform4f = nullptr;
+PFNGLUNIFORM3FVPROC glUniform3fv = nullptr;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = nullptr;
 
 bool ExtensionsInit()
@@ -56,12 +63,18 @@ bool ExtensionsInit()
     OGL_GET_EXTENSION(PFNGLGENBUFFERSPROC, glGenBuffers);
     OGL_GET_EXTENSION(PFNGLBINDBUFFERPROC, glBindBuffer);
     OGL_GET_EXTENSION(PFNGLBUFFERDATAPROC, glBufferData);
+    OGL_GET_EXTENSION(PFNGLBUFFERSUBDATAPROC, glBufferSubData);
     OGL_GET_EXTENSION(PFNGLDELETEBUFFERSPROC, glDeleteBuffers);
 
     // Vertex Attrib Array
     OGL_GET_EXTENSION(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray);
     OGL_GET_EXTENSION(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer);
     OGL_GET_EXTENSION(PFNGLDISABLEVERTEXATTRIBARRAYPROC, glDisableVertexAttribArray);
+    OGL_GET_EXTENSION(PFNGLVERTEXATTRIBIPOINTERPROC, glVertexAttribIPointer);
+    OGL_GET_EXTENSION(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor);
+
+    // Drawing
+    OGL_GET_EXTENSION(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced);
 
     // Vertex Array Objects
     OGL_GET_EXTENSION(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays);
@@ -84,6 +97,7 @@ bool ExtensionsInit()
     OGL_GET_EXTENSION(PFNGLUSEPROGRAMPROC, glUseProgram);
     OGL_GET_EXTENSION(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation);
     OGL_GET_EXTENSION(PFNGLUNIFORM4FPROC, glUniform4f);
+    OGL_GET_EXTENSION(PFNGLUNIFORM3FVPROC, glUniform3fv);
     OGL_GET_EXTENSION(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv);
 
     return allExtensionsAvailable;
@@ -49,6 +49,7 @@ void Mesh::Bind() const noexcept
     if (mPrimitiveType == MeshPrimitiveType::Points)
     {
         glDisableVertexAttribArray(2);
+        glVertexAttribDivisor(1, 0);
         // 2 attributes total (pos, color) - stride of single vertex is 7 * sizeof(float)
         // Attribute 0 - Vertex position, at ptr = 0 (the beginning of specified vertex)
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float),
@@ -58,20 +59,28 @@ void Mesh::Bind() const noexcept
         glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float),
                               reinterpret_cast<const void*>(3 * sizeof(float)));
     }
-    else if (mPrimitiveType == MeshPrimitiveType::Triangles)
+    else if (mPrimitiveType == MeshPrimitiveType::Cubes)
     {
+        // Attribute 0 is the shared cube, bound by Renderer. Per instance attributes (packed
+        // instance, see CubeInstance) - stride is 8 bytes.
         glEnableVertexAttribArray(2);
-        // 3 attributes total (pos, norm, color) - stride of single vertex is 10 * sizeof(float)
-        // Attribute 0 - Vertex position, at ptr = 0 (the beginning of specified vertex)
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 10 * sizeof(float),
-                              reinterpret_cast<const void*>(0));
-        // Attribute 1 - Vertex normal at ptr = 3 * sizeof(float) (in other words, right after
-        //               Vertex Position attribute).
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 10 * sizeof(float),
-                              reinterpret_cast<const void*>(3 * sizeof(float)));
-        // Attribute 2 - Vertex color at ptr right after position and normal (6 * sizeof(float).
-        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 10 * sizeof(float),
-                              reinterpret_cast<const void*>(6 * sizeof(float)));
+        // Attribute 1 - Voxel position xyz and visible faces, 4 bytes at ptr = 0
+        glVertexAttribIPointer(1, 4, GL_UNSIGNED_BYTE, 8, reinterpret_cast<const void*>(0));
+        glVertexAttribDivisor(1, 1);
+        // Attribute 2 - Voxel palette index, single byte right after the position
+        glVertexAttribIPointer(2, 1, GL_UNSIGNED_BYTE, 8, reinterpret_cast<const void*>(4));
+        glVertexAttribDivisor(2, 1);
+    }
+    else
+    {
+        // Triangles and Quads
+        glDisableVertexAttribArray(2);
+        glVertexAttribDivisor(1, 0);
+        // 2 integer attributes (packed vertex, see PackedVertex) - stride is 8 bytes
+        // Attribute 0 - Corner position xyz and normal index, 4 bytes at ptr = 0
+        glVertexAttribIPointer(0, 4, GL_UNSIGNED_BYTE, 8, reinterpret_cast<const void*>(0));
+        // Attribute 1 - Voxel palette index, single byte right after the position
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, 8, reinterpret_cast<const void*>(4));
     }
 }
 
@@ -97,6 +106,12 @@ void Mesh::Update(const MeshUpdateDesc& desc) noexcept
     mVertCount = static_cast<GLsizei>(desc.vertCount);
 }
 
+void Mesh::UpdateRange(size_t offset, const void* dataPtr, size_t dataSize) noexcept
+{
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, dataSize, dataPtr);
+}
+
 void Mesh::SetLocked(bool locked) noexcept
 {
     mLocked = locked;
@@ -112,6 +127,11 @@ void Mesh::SetPrimitiveType(MeshPrimitiveType type) noexcept
     mPrimitiveType = type;
 }
 
+MeshPrimitiveType Mesh::GetPrimitiveType() const noexcept
+{
+    return mPrimitiveType;
+}
+
 GLenum Mesh::GetGLPrimitiveType() const noexcept
 {
     switch (mPrimitiveType)
@@ -119,6 +139,8 @@ GLenum Mesh::GetGLPrimitiveType() const noexcept
     case MeshPrimitiveType::Points:
         return GL_POINTS;
     case MeshPrimitiveType::Triangles:
+    case MeshPrimitiveType::Quads:
+    case MeshPrimitiveType::Cubes:
         return GL_TRIANGLES;
     default:
         return GL_NONE;
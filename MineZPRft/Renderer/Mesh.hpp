@@ -38,7 +38,9 @@ struct MeshUpdateDesc
 enum class MeshPrimitiveType: unsigned char
 {
     Points = 0,
-    Triangles
+    Triangles,
+    Quads,      ///< Four vertices per quad, drawn as triangles using Renderer's shared indices.
+    Cubes       ///< Cube instance per vertex, drawn using Renderer's shared cube.
 };
 
 class Mesh
@@ -94,6 +96,18 @@ public:
      */
     void Update(const MeshUpdateDesc& desc) noexcept;
 
+    /**
+     * Replace part of Mesh's data, leaving the rest and the vertex count untouched.
+     *
+     * @param offset   Offset of replaced data, in bytes.
+     * @param dataPtr  New data.
+     * @param dataSize Size of replaced data, in bytes. Range must lie within data provided by
+     *                 last Update().
+     *
+     * @remarks Just like Update(), the function does no error checking.
+     */
+    void UpdateRange(size_t offset, const void* dataPtr, size_t dataSize) noexcept;
+
     /**
      * Sets a "locked" flag for Mesh object.
      *
@@ -117,6 +131,11 @@ public:
      */
     void SetPrimitiveType(MeshPrimitiveType type) noexcept;
 
+    /**
+     * Acquires Mesh Primitive type.
+     */
+    MeshPrimitiveType GetPrimitiveType() const noexcept;
+
     /**
      * Acquires Mesh Primitive type translated to OpenGL macro form.
      */
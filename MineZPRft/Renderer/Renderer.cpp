@@ -10,16 +10,31 @@
 #include "Extensions.hpp"
 #include "Math/Vector.hpp"
 #include "Common/Logger.hpp"
+#include "Terrain/ChunkMesher.hpp"
+#include "Terrain/Voxel.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 using namespace OGLExt;
 
+namespace {
+
+// Quads covered by the shared index buffer up front - more than chunks of generated terrain
+// usually need, larger meshes grow the buffer
+const size_t INITIAL_QUAD_INDEX_CAPACITY = 16384;
+
+} // namespace
+
 Renderer::Renderer()
     : mCamera()
     , mTerrainShaderNaive()
     , mTerrainShaderUniforms()
     , mDummyVAO(GL_NONE)
+    , mQuadIndexBuffer(GL_NONE)
+    , mQuadIndexCapacity(0)
+    , mCubeBuffer(GL_NONE)
     , initDone(false)
 {
 }
@@ -31,6 +46,8 @@ Renderer::~Renderer()
     glBindVertexArray(GL_NONE);
 
     // destroy
+    glDeleteBuffers(1, &mQuadIndexBuffer);
+    glDeleteBuffers(1, &mCubeBuffer);
     glDeleteVertexArrays(1, &mDummyVAO);
 }
 
@@ -64,6 +81,19 @@ void Renderer::Init(const RendererDesc& desc)
     glGenVertexArrays(1, &mDummyVAO);
     glBindVertexArray(mDummyVAO);
 
+    // Index buffer shared by all quad meshes. It stays bound to the VAO for the whole lifetime.
+    glGenBuffers(1, &mQuadIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mQuadIndexBuffer);
+    ReserveQuadIndices(INITIAL_QUAD_INDEX_CAPACITY);
+
+    // Cube shared by all cube meshes, every instance draws it once
+    std::vector<PackedVertex> cubeVerts;
+    ChunkMesher::GenerateCube(cubeVerts);
+    glGenBuffers(1, &mCubeBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mCubeBuffer);
+    glBufferData(GL_ARRAY_BUFFER, cubeVerts.size() * sizeof(PackedVertex), cubeVerts.data(),
+                 GL_STATIC_DRAW);
+
     // Load camera
     CameraDesc cd;
     cd.fov = 60.0f;
@@ -107,6 +137,35 @@ void Renderer::Init(const RendererDesc& desc)
     mMainShaderUniforms.playerPos = mMainShader.GetUniform("playerPos");
     // TODO throw if incorrect uniform locations
 
+    // Load cube shader, lit the same way as the main one
+    sd.vsPath = desc.shaderPath + "/TerrainCubeVS.glsl";
+    mCubeShader.Init(sd);
+
+    mCubeShader.MakeCurrent();
+    mCubeShaderUniforms.worldMatrix = mCubeShader.GetUniform("worldMat");
+    mCubeShaderUniforms.viewMatrix = mCubeShader.GetUniform("viewMat");
+    mCubeShaderUniforms.perspectiveMatrix = mCubeShader.GetUniform("perspMat");
+    mCubeShaderUniforms.playerPos = mCubeShader.GetUniform("playerPos");
+    // TODO throw if incorrect uniform locations
+
+    // Greedy mesh vertices and cube instances carry only a voxel palette index, colors are
+    // looked up by the shaders
+    static_assert(static_cast<VoxelUnderType>(VoxelType::Unknown) < 16,
+                  "Voxel palette does not fit voxelPalette arrays of shaders");
+    std::vector<float> palette(3 * (static_cast<VoxelUnderType>(VoxelType::Unknown) + 1));
+    for (const auto& voxel : VoxelDB)
+    {
+        size_t index = 3 * static_cast<VoxelUnderType>(voxel.first);
+        palette[index] = voxel.second.colorRed;
+        palette[index + 1] = voxel.second.colorGreen;
+        palette[index + 2] = voxel.second.colorBlue;
+    }
+    glUniform3fv(mCubeShader.GetUniform("voxelPalette"), static_cast<GLsizei>(palette.size() / 3),
+                 palette.data());
+    mMainShader.MakeCurrent();
+    glUniform3fv(mMainShader.GetUniform("voxelPalette"), static_cast<GLsizei>(palette.size() / 3),
+                 palette.data());
+
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
     initDone = true;
@@ -177,36 +236,65 @@ void Renderer::DrawPerMeshArray(const MeshArrayType& meshArray)
             const GLenum primType = mesh->GetGLPrimitiveType();
             mesh->Bind();
 
-            if (primType == GL_POINTS)
-            {
-                mTerrainShaderNaive.MakeCurrent();
-                glUniformMatrix4fv(mTerrainShaderUniforms.worldMatrix, 1, false,
-                                   mesh->GetWorldMatrixRaw());
-                glUniformMatrix4fv(mTerrainShaderUniforms.viewMatrix, 1, false,
-                                   mCamera.GetViewRaw());
-                glUniformMatrix4fv(mTerrainShaderUniforms.perspectiveMatrix, 1, false,
-                                   mCamera.GetPerspectiveRaw());
-                const float* posRaw = mCamera.GetPosRaw();
-                glUniform4f(mTerrainShaderUniforms.playerPos,
-                            posRaw[0], posRaw[1], posRaw[2], 1.0f);
-            }
-            else if (primType == GL_TRIANGLES)
+            Shader* shader;
+            const TerrainShaderLocs* uniforms;
+            switch (mesh->GetPrimitiveType())
             {
-                mMainShader.MakeCurrent();
-                glUniformMatrix4fv(mMainShaderUniforms.worldMatrix, 1, false,
-                                   mesh->GetWorldMatrixRaw());
-                glUniformMatrix4fv(mMainShaderUniforms.viewMatrix, 1, false,
-                                   mCamera.GetViewRaw());
-                glUniformMatrix4fv(mMainShaderUniforms.perspectiveMatrix, 1, false,
-                                   mCamera.GetPerspectiveRaw());
-                const float* posRaw = mCamera.GetPosRaw();
-                glUniform4f(mMainShaderUniforms.playerPos,
-                            posRaw[0], posRaw[1], posRaw[2], 1.0f);
+            case MeshPrimitiveType::Points:
+                shader = &mTerrainShaderNaive;
+                uniforms = &mTerrainShaderUniforms;
+                break;
+            case MeshPrimitiveType::Cubes:
+                // Per vertex attribute comes from the shared cube
+                glBindBuffer(GL_ARRAY_BUFFER, mCubeBuffer);
+                glVertexAttribIPointer(0, 4, GL_UNSIGNED_BYTE, sizeof(PackedVertex),
+                                       reinterpret_cast<const void*>(0));
+                shader = &mCubeShader;
+                uniforms = &mCubeShaderUniforms;
+                break;
+            default:
+                shader = &mMainShader;
+                uniforms = &mMainShaderUniforms;
+                break;
             }
 
+            shader->MakeCurrent();
+            glUniformMatrix4fv(uniforms->worldMatrix, 1, false, mesh->GetWorldMatrixRaw());
+            glUniformMatrix4fv(uniforms->viewMatrix, 1, false, mCamera.GetViewRaw());
+            glUniformMatrix4fv(uniforms->perspectiveMatrix, 1, false,
+                               mCamera.GetPerspectiveRaw());
+            const float* posRaw = mCamera.GetPosRaw();
+            glUniform4f(uniforms->playerPos, posRaw[0], posRaw[1], posRaw[2], 1.0f);
+
             vertCount = mesh->GetVertCount();
             if (vertCount > 0)
-                glDrawArrays(primType, 0, mesh->GetVertCount());
+            {
+                if (mesh->GetPrimitiveType() == MeshPrimitiveType::Cubes)
+                    glDrawArraysInstanced(primType, 0, ChunkMesher::CUBE_VERTEX_COUNT, vertCount);
+                else if (mesh->GetPrimitiveType() == MeshPrimitiveType::Quads)
+                {
+                    GLsizei quadCount = vertCount / ChunkMesher::QUAD_VERTEX_COUNT;
+                    ReserveQuadIndices(quadCount);
+                    glDrawElements(primType, quadCount * ChunkMesher::QUAD_INDEX_COUNT,
+                                   GL_UNSIGNED_INT, nullptr);
+                }
+                else
+                    glDrawArrays(primType, 0, vertCount);
+            }
         }
     }
 }
+
+void Renderer::ReserveQuadIndices(size_t quadCount) noexcept
+{
+    if (quadCount <= mQuadIndexCapacity)
+        return;
+
+    // Grow at least twice, so a few large meshes do not rebuild the buffer every frame
+    mQuadIndexCapacity = std::max(quadCount, mQuadIndexCapacity * 2);
+    std::vector<unsigned int> indices;
+    ChunkMesher::GenerateQuadIndices(mQuadIndexCapacity, indices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
+                 GL_STATIC_DRAW);
+    LOG_D("Quad index buffer grown to " << mQuadIndexCapacity << " quads");
+}
@@ -126,12 +126,22 @@ private:
 
     void DrawPerMeshArray(const MeshArrayType& mesh);
 
+    /**
+     * Grows shared quad index buffer, so it can be used to draw @p quadCount quads.
+     */
+    void ReserveQuadIndices(size_t quadCount) noexcept;
+
     Camera mCamera;
     Shader mTerrainShaderNaive;
     TerrainShaderLocs mTerrainShaderUniforms;
     Shader mMainShader;
-    TerrainShaderLocs mMainShaderUniforms; // right now both shaders use same uniform sets
+    TerrainShaderLocs mMainShaderUniforms; // right now all shaders use same uniform sets
+    Shader mCubeShader;
+    TerrainShaderLocs mCubeShaderUniforms;
     GLuint mDummyVAO; // We don't need this, but OGL has its needs and won't cooperate without it
+    GLuint mQuadIndexBuffer; // Indices shared by all Meshes of Quads primitive type
+    size_t mQuadIndexCapacity; // Amount of quads mQuadIndexBuffer can draw
+    GLuint mCubeBuffer; // Cube drawn for every instance of Meshes of Cubes primitive type
     GLenum mCurrentPrimitiveType; // to reduce switching between shaders
     bool initDone;
     MeshArrayType mMeshArray;
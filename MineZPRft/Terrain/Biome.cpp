@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Biome definitions.
+ */
+
+#include "Biome.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+
+// Indexed by Biome
+const BiomeDesc BIOMES[] =
+{
+    { VoxelType::Snow, VoxelType::Dirt, 0.5f, 2.0f },     // Tundra
+    { VoxelType::Stone, VoxelType::Stone, 3.0f, 4.0f },   // Mountains
+    { VoxelType::Sand, VoxelType::Sand, 0.5f, 0.0f },     // Desert
+    { VoxelType::Grass, VoxelType::Dirt, 1.0f, 2.0f },    // Plains
+};
+
+// Height profiles are blended over climate values within 1 / (2 * BIOME_BLEND) from the border
+const float BIOME_BLEND = 2.5f;
+
+// Weight of the "hot" or "humid" half of climate space
+float BlendWeight(float value)
+{
+    return std::min(std::max(value * BIOME_BLEND + 0.5f, 0.0f), 1.0f);
+}
+
+float Lerp(float t, float a, float b)
+{
+    return a + t * (b - a);
+}
+
+// Bilinear blend of a height profile value between the four biomes in climate space
+float BlendProfile(float temperature, float humidity, float tundra, float mountains, float desert,
+                   float plains)
+{
+    float t = BlendWeight(temperature);
+    float h = BlendWeight(humidity);
+    return Lerp(t, Lerp(h, tundra, mountains), Lerp(h, desert, plains));
+}
+
+} // namespace
+
+
+const BiomeDesc& GetBiomeDesc(Biome biome) noexcept
+{
+    return BIOMES[static_cast<int>(biome)];
+}
+
+BiomeDesc EvaluateClimate(float temperature, float humidity) noexcept
+{
+    const BiomeDesc& tundra = BIOMES[static_cast<int>(Biome::Tundra)];
+    const BiomeDesc& mountains = BIOMES[static_cast<int>(Biome::Mountains)];
+    const BiomeDesc& desert = BIOMES[static_cast<int>(Biome::Desert)];
+    const BiomeDesc& plains = BIOMES[static_cast<int>(Biome::Plains)];
+
+    BiomeDesc result = BIOMES[static_cast<int>(SelectBiome(temperature, humidity))];
+    result.heightScale = BlendProfile(temperature, humidity, tundra.heightScale,
+                                      mountains.heightScale, desert.heightScale,
+                                      plains.heightScale);
+    result.heightOffset = BlendProfile(temperature, humidity, tundra.heightOffset,
+                                       mountains.heightOffset, desert.heightOffset,
+                                       plains.heightOffset);
+    return result;
+}
+
+void BlendHeightProfiles(const float* temperature, const float* humidity, float* heightScale,
+                         float* heightOffset, size_t count) noexcept
+{
+    const BiomeDesc& tundra = BIOMES[static_cast<int>(Biome::Tundra)];
+    const BiomeDesc& mountains = BIOMES[static_cast<int>(Biome::Mountains)];
+    const BiomeDesc& desert = BIOMES[static_cast<int>(Biome::Desert)];
+    const BiomeDesc& plains = BIOMES[static_cast<int>(Biome::Plains)];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        heightScale[i] = BlendProfile(temperature[i], humidity[i], tundra.heightScale,
+                                      mountains.heightScale, desert.heightScale,
+                                      plains.heightScale);
+        heightOffset[i] = BlendProfile(temperature[i], humidity[i], tundra.heightOffset,
+                                       mountains.heightOffset, desert.heightOffset,
+                                       plains.heightOffset);
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Biome declarations.
+ */
+
+#ifndef __TERRAIN_BIOME_HPP__
+#define __TERRAIN_BIOME_HPP__
+
+#include "Voxel.hpp"
+
+#include <cstddef>
+
+/**
+ * Biomes selected by climate. Each one occupies a quarter of temperature/humidity space.
+ *
+ * Order matters - see SelectBiome().
+ */
+enum class Biome: unsigned char
+{
+    Tundra = 0,     ///< Cold and dry - flat, snow covered lowlands.
+    Mountains,      ///< Cold and humid - high, rocky peaks.
+    Desert,         ///< Hot and dry - low sand dunes.
+    Plains,         ///< Hot and humid - gentle, grassy hills.
+};
+
+/**
+ * Describes how terrain looks inside a biome.
+ */
+struct BiomeDesc
+{
+    VoxelType surface;      ///< Topmost voxel of a column.
+    VoxelType subsurface;   ///< Few voxels right below the surface.
+    float heightScale;      ///< Multiplier of heightmap's height.
+    float heightOffset;     ///< Voxels added on top of the stone base.
+};
+
+/**
+ * Pick biome of a column.
+ *
+ * @param temperature Temperature in -1..1 range.
+ * @param humidity    Humidity in -1..1 range.
+ *
+ * Called for every generated column, so it is branchless and inlined.
+ */
+inline Biome SelectBiome(float temperature, float humidity) noexcept
+{
+    return static_cast<Biome>((temperature >= 0.0f) * 2 + (humidity >= 0.0f));
+}
+
+/**
+ * Acquire description of @p biome, with its own (not blended) height profile.
+ */
+const BiomeDesc& GetBiomeDesc(Biome biome) noexcept;
+
+/**
+ * Describe terrain of a column.
+ *
+ * @param temperature Temperature in -1..1 range.
+ * @param humidity    Humidity in -1..1 range.
+ * @return Voxels of biome picked by SelectBiome(). Height profile is blended with neighbouring
+ *         biomes close to their border, so there are no cliffs between biomes.
+ */
+BiomeDesc EvaluateClimate(float temperature, float humidity) noexcept;
+
+/**
+ * Blend height profiles of many columns at once.
+ *
+ * @param temperature  Temperatures of columns.
+ * @param humidity     Humidities of columns.
+ * @param heightScale  Output BiomeDesc::heightScale of columns.
+ * @param heightOffset Output BiomeDesc::heightOffset of columns.
+ * @param count        Amount of columns.
+ *
+ * Gives the same height profiles as EvaluateClimate(), but processes arrays in a tight loop.
+ */
+void BlendHeightProfiles(const float* temperature, const float* humidity, float* heightScale,
+                         float* heightOffset, size_t count) noexcept;
+
+#endif // __TERRAIN_BIOME_HPP__
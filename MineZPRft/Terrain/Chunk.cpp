@@ -6,54 +6,74 @@
 
 #define NOMINMAX
 #include "Chunk.hpp"
+#include "ChunkMesher.hpp"
 
 #include "Common/Logger.hpp"
 #include "Math/Common.hpp"
-#include "NoiseGenerator.hpp"
 #include "Renderer/Renderer.hpp"
 #include "Common/FileSystem.hpp"
 #include "Math/Vector.hpp"
 #include "Math/Matrix.hpp"
 
-#include <fstream>
+#include <algorithm>
+#include <cmath>
 
 namespace
 {
-// TODO Get rid of CHUNK_* consts. They should be customizable.
-// TODO Consider moving CHUNK_DIR to user home directory
-const std::string CHUNK_DIR = "ChunkBank";
-const std::string CHUNK_FILEEXT = ".riQrll";
-const int HEIGHTMAP_HEIGHT = 16;
-const double AIR_THRESHOLD = 0.3;
-const int FLOAT_COUNT_PER_VERTEX_NAIVE = 7;
-const int FLOAT_COUNT_PER_VERTEX_GREEDY = 10;
-const float ALPHA_COMPONENT = 1.0f; // Alpha color component should stay at 1,0 (full opacity).
 
+// Bits of Chunk::mMissingNeighbours
+const unsigned char MISSING_X_PLUS = 0x01;
+const unsigned char MISSING_X_MINUS = 0x02;
+const unsigned char MISSING_Z_PLUS = 0x04;
+const unsigned char MISSING_Z_MINUS = 0x08;
 
-} // namespace
+// Vertices left free after every non-empty section of greedy Mesh - room for a few more quads
+// before an edit forces laying out the whole Mesh again
+const size_t SECTION_SPARE_VERTS = 16 * ChunkMesher::QUAD_VERTEX_COUNT;
+
+// Vertex filling spare space of sections. Quads made of it have no area and are not rasterized.
+const PackedVertex EMPTY_VERTEX = { 0, 0, 0, 0, 0, { 0, 0, 0 } };
 
+} // namespace
 
 Chunk::Chunk()
     : mState(ChunkState::NotGenerated)
-    , mFloatCountPerVertex(1.0f)
+    , mTaskReserved(false)
+    , mCoordX(0)
+    , mCoordZ(0)
+    , mMeshingMethod(MeshingMethod::Naive)
+    , mLod(0)
+    , mMeshLod(0)
+    , mMissingNeighbours(0)
+    , mFullUpload(false)
+    , mDirtyBegin(0)
+    , mDirtyEnd(0)
 {
-    for (VoxelType& voxel : mVoxels)
-        voxel = VoxelType::Air;
+    std::fill(mSectionSlots, mSectionSlots + ChunkMesher::SECTION_COUNT, SectionRange{ 0, 0 });
 }
 
 Chunk::Chunk(const Chunk& other)
+    : mVoxels(other.mVoxels)
+    , mTaskReserved(false)
+    , mCoordX(other.mCoordX)
+    , mCoordZ(other.mCoordZ)
+    , mLod(other.mLod.load())
 {
-    for (int i = 0; i < CHUNK_X * CHUNK_Y * CHUNK_Z; ++i)
-        mVoxels[i] = other.mVoxels[i];
-
     mVerts = other.mVerts;
-    mGreedyGenerated = other.mGreedyGenerated;
-    mTerrainGenerator = other.mTerrainGenerator;
-    mFloatCountPerVertex = other.mFloatCountPerVertex;
+    mPackedVerts = other.mPackedVerts;
+    mCubeInstances = other.mCubeInstances;
+    mMeshingMethod = other.mMeshingMethod;
+    mMeshLod = other.mMeshLod;
+    mMissingNeighbours = other.mMissingNeighbours;
+    std::copy(other.mSectionSlots, other.mSectionSlots + ChunkMesher::SECTION_COUNT,
+              mSectionSlots);
+    mFullUpload = false;
+    mDirtyBegin = mDirtyEnd = 0;
+    MeshUpdateDesc mud = GetMeshUpdateDesc();
     MeshDesc md;
-    md.dataPtr = mVerts.data();
-    md.dataSize = mVerts.size() * sizeof(float);
-    md.vertCount = mVerts.size() / mFloatCountPerVertex;
+    md.dataPtr = mud.dataPtr;
+    md.dataSize = mud.dataSize;
+    md.vertCount = mud.vertCount;
     mMesh.Init(md);
     mState = other.mState.load();
     if (mState == ChunkState::Updated)
@@ -78,22 +98,12 @@ void Chunk::Init()
 
 void Chunk::SetVoxel(size_t x, size_t y, size_t z, VoxelType voxel) noexcept
 {
-    // calculate the index
-    size_t index = 0;
-    if (!CalculateIndex(x, y, z, index))
-        return;
-
-    mVoxels[index] = voxel;
+    mVoxels.SetVoxel(x, y, z, voxel);
 }
 
 VoxelType Chunk::GetVoxel(size_t x, size_t y, size_t z) noexcept
 {
-    // calculate the index
-    size_t index = 0;
-    if (!CalculateIndex(x, y, z, index))
-        return VoxelType::Unknown;
-
-    return mVoxels[index];
+    return mVoxels.GetVoxel(x, y, z);
 }
 
 void Chunk::Shift(int chunkX, int chunkZ)
@@ -106,119 +116,178 @@ void Chunk::Shift(int chunkX, int chunkZ)
     mMesh.SetWorldMatrix(CreateTranslationMatrix(shift) * CreateRotationMatrixY(MATH_PIF));
 }
 
-void Chunk::Generate(int chunkX, int chunkZ, int currentChunkX, int currentChunkZ,
-                     bool useGreedyMeshing) noexcept
+void Chunk::GenerateTerrain(int coordX, int coordZ, const TerrainGenerator& generator,
+                            const ChunkManifest& manifest, DecorationQueue& decoration) noexcept
 {
-    if (useGreedyMeshing)
+    mCoordX = coordX;
+    mCoordZ = coordZ;
+
+    // If Chunk was saved to disk, load it from file. Manifest spares us
+    // a failed open() for chunks that were never saved.
+    if (manifest.MayContain(mCoordX, mCoordZ) && LoadFromDisk())
     {
-        mTerrainGenerator = std::bind(&Chunk::GenerateVBOGreedy, this);
-        mFloatCountPerVertex = FLOAT_COUNT_PER_VERTEX_GREEDY;
+        LOG_D("Chunk [" << mCoordX << ", "
+              << mCoordZ << "] was successfully read from disk.");
     }
     else
     {
-        mTerrainGenerator = std::bind(&Chunk::GenerateVBONaive, this);
-        mFloatCountPerVertex = FLOAT_COUNT_PER_VERTEX_NAIVE;
+        generator.Generate(mVoxels.GetData(), mCoordX, mCoordZ);
+        LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] generated.");
     }
 
-    // Set coords for chunk
-    mCoordX = chunkX + currentChunkX;
-    mCoordZ = chunkZ + currentChunkZ;
+    // From now on neighbours can place their decorations directly in our voxels
+    decoration.Attach(mCoordX, mCoordZ, mVoxels.GetData());
+
+    mState = ChunkState::TerrainGenerated;
+    mTaskReserved = false;
+}
+
+void Chunk::Decorate(const TerrainGenerator& generator, DecorationQueue& decoration) noexcept
+{
+    decoration.Decorate(generator, mCoordX, mCoordZ);
+
+    mState = ChunkState::Decorated;
+    mTaskReserved = false;
+}
 
-    // If Chunk was saved to disk, load it from file.
-    if (LoadFromDisk())
+void Chunk::GenerateMesh(MeshingMethod method, const ChunkNeighbours& neighbours) noexcept
+{
+    switch (method)
     {
-        mTerrainGenerator();
+    case MeshingMethod::Instanced:
+        GenerateVBOInstanced(neighbours);
+        break;
+    case MeshingMethod::Greedy:
+        GenerateVBOGreedy(neighbours);
+        break;
+    default:
+        GenerateVBONaive(neighbours);
+        break;
+    }
 
-        LOG_D("Chunk [" << mCoordX << ", "
-              << mCoordZ << "] was successfully read from disk.");
+    mTaskReserved = false;
+}
+
+void Chunk::RemeshAround(int x, int y, int z, MeshingMethod method,
+                         const ChunkNeighbours& neighbours) noexcept
+{
+    // Only greedy Mesh has sections to patch. Coarse Mesh has them, but a single voxel changes
+    // a whole block of downsampled voxels, which might span several sections.
+    if (method != MeshingMethod::Greedy)
+    {
+        GenerateMesh(method, neighbours);
         return;
     }
 
-    NoiseGenerator& noiseGen = NoiseGenerator::GetInstance();
+    if (mMeshingMethod != MeshingMethod::Greedy || mLod != 0 || mMeshLod != 0)
+        GenerateVBOGreedy(neighbours);
+    else
+        RemeshSections(x, y, z, neighbours);
 
-    // Further "generation loops" will assume that bottom two layers of chunk are
-    // filled with Bedrock, so their Y iterator will begin from 2.
+    mTaskReserved = false;
+}
 
-    // Stage 0 - cleanup before use
-    for (int i = 0; i < CHUNK_X * CHUNK_Y * CHUNK_Z; ++i)
-        mVoxels[i] = VoxelType::Air;
+void Chunk::RemeshSections(int x, int y, int z, const ChunkNeighbours& neighbours) noexcept
+{
+    // Faces of the voxel itself and of its six neighbours might have changed
+    const int offsets[][3] = {
+        { 0, 0, 0 }, { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
 
-    // Stage 1 - fill bottom quarter of chunk with stone
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 2; y < CHUNK_Y / 4; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-                SetVoxel(x, y, z, VoxelType::Stone);
+    bool touched[ChunkMesher::SECTION_COUNT] = { false };
+    for (const auto& offset : offsets)
+    {
+        int nx = x + offset[0];
+        int ny = y + offset[1];
+        int nz = z + offset[2];
+        if (nx < 0 || nx >= CHUNK_X || ny < 0 || ny >= CHUNK_Y || nz < 0 || nz >= CHUNK_Z)
+            continue;
 
-    LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] Stage 1 done");
+        touched[ChunkMesher::GetSectionIndex(nx, ny, nz)] = true;
+    }
 
-    // Stage 2.1 - generate a heightmap using Perlin
-    double noise;
-    std::vector<double> heightMap;
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int x = 0; x < CHUNK_X; ++x)
+    // Other sections were meshed with the old apron, so sides missing back then stay marked
+    MeshingScratch& scratch = ChunkMesher::GetThreadScratch();
+    unsigned char missingNeighbours = mMissingNeighbours;
+    BuildApron(neighbours, scratch.apron);
+    mMissingNeighbours |= missingNeighbours;
+
+    for (int section = 0; section < ChunkMesher::SECTION_COUNT; ++section)
+    {
+        if (touched[section] && !RemeshSection(section, scratch.apron))
         {
-            // TODO adjust scaling
-            // Noise arguments are shifted according to Chunk::Generate() arguments.
-            // This way the map will be seamless and the chunks connected.
-            noise = noiseGen.Noise((x + (CHUNK_Z * mCoordZ)) / 32.0,
-                                   0.0,
-                                   (z + (CHUNK_X * mCoordX)) / 32.0);
-
-            // Noise-returned values span -1..1 range,
-            // Add 1 to them to convert it to 0..2 range.
-            noise += 1.0;
-
-            // To make Stage 2.2 easier, convert values from range 0..2 to 0..HEIGHTMAP_HEIGHT
-            noise *= HEIGHTMAP_HEIGHT / 2;
-
-            // Dump the data inside vector for further analysis
-            heightMap.push_back(noise);
+            // Section outgrew its spare vertices - whole Mesh gets new slots
+            GenerateVBOGreedy(neighbours);
+            return;
         }
+    }
 
-    // Stage 2.2 - convert generated heightmap to stone voxels
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = CHUNK_Y / 4; y < (CHUNK_Y / 4) + HEIGHTMAP_HEIGHT; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                // Add a stone voxel if heightmap's value is higher
-                // than currently processed voxel's Y coordinate.
-                if (heightMap[x * CHUNK_Z + z] >= static_cast<double>(y - (CHUNK_Y / 4)))
-                    SetVoxel(x, y, z, VoxelType::Stone);
-            }
+    mState = ChunkState::Generated;
+}
 
-    LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] Stage 2 done");
-    /*
-    // Stage 3 - cut through the terrain with some Perlin-generated caves
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 2; y < CHUNK_Y; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                // TODO adjust scaling
-                // NOTE chunkZ applies to X coordinate and chunkX applies to Z coordinate.
-                //      Otherwise, the chunk would be rotated and the map would lost its
-                //      seamlessness.
-                noise = noiseGen.Noise((x + CHUNK_X * mCoordX) * 0.1,
-                                        y * 0.1,
-                                       (z + CHUNK_Z * mCoordZ) * 0.1);
-
-                if (noise > AIR_THRESHOLD)
-                    SetVoxel(x, y, z, VoxelType::Air);
-            }
+bool Chunk::NeedsBorderRemesh(const ChunkNeighbours& neighbours) const noexcept
+{
+    if (mMeshLod != 0)
+        return false;
 
-    LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] Stage 3 done");*/
+    return NeedsSideRemesh(MISSING_X_PLUS, neighbours.xPlus) ||
+           NeedsSideRemesh(MISSING_X_MINUS, neighbours.xMinus) ||
+           NeedsSideRemesh(MISSING_Z_PLUS, neighbours.zPlus) ||
+           NeedsSideRemesh(MISSING_Z_MINUS, neighbours.zMinus);
+}
 
-    // Stage 4 - force-fill first two layers of the ground with bedrock
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 0; y < 2; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-                SetVoxel(x, y, z, VoxelType::Bedrock);
+bool Chunk::HasMissingNeighbours() const noexcept
+{
+    return mMissingNeighbours != 0;
+}
 
-    LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] Stage 4 done");
+void Chunk::SetLod(unsigned int lod) noexcept
+{
+    mLod = static_cast<unsigned char>(std::min(lod, ChunkMesher::LOD_LEVEL_COUNT - 1));
+}
 
-    mTerrainGenerator();
-    LOG_D("  Chunk [" << mCoordX << ", " << mCoordZ << "] generated.");
+unsigned int Chunk::GetLod() const noexcept
+{
+    return mLod;
+}
+
+bool Chunk::NeedsLodRemesh() const noexcept
+{
+    return mMeshingMethod == MeshingMethod::Greedy && mMeshLod != mLod;
+}
+
+bool Chunk::ReserveTask(ChunkState state) noexcept
+{
+    if (mTaskReserved.exchange(true))
+        return false;
 
-    return;
+    if (mState != state)
+    {
+        mTaskReserved = false;
+        return false;
+    }
+
+    return true;
+}
+
+bool Chunk::IsTaskReserved() const noexcept
+{
+    return mTaskReserved;
+}
+
+ChunkState Chunk::GetState() const noexcept
+{
+    return mState;
+}
+
+int Chunk::GetCoordX() const noexcept
+{
+    return mCoordX;
+}
+
+int Chunk::GetCoordZ() const noexcept
+{
+    return mCoordZ;
 }
 
 const Mesh* Chunk::GetMeshPtr()
@@ -228,21 +297,18 @@ const Mesh* Chunk::GetMeshPtr()
 
 void Chunk::CommitMeshUpdate()
 {
-    MeshUpdateDesc md;
-    md.dataPtr = mVerts.data();
-    md.dataSize = mVerts.size() * sizeof(float);
-    md.vertCount = mVerts.size() / mFloatCountPerVertex;
-    mMesh.Update(md);
+    if (mFullUpload)
+        mMesh.Update(GetMeshUpdateDesc());
+    else if (mDirtyBegin < mDirtyEnd)
+        mMesh.UpdateRange(mDirtyBegin * sizeof(PackedVertex), mPackedVerts.data() + mDirtyBegin,
+                          (mDirtyEnd - mDirtyBegin) * sizeof(PackedVertex));
+
+    mFullUpload = false;
+    mDirtyBegin = mDirtyEnd = 0;
     mState = ChunkState::Updated;
     mMesh.SetLocked(false);
 }
 
-void Chunk::ResetState() noexcept
-{
-    mState = ChunkState::NotGenerated;
-    mMesh.SetLocked(true);
-}
-
 bool Chunk::IsGenerated() const noexcept
 {
     return mState == ChunkState::Generated;
@@ -253,418 +319,177 @@ bool Chunk::NeedsGeneration() const noexcept
     return mState == ChunkState::NotGenerated;
 }
 
-bool Chunk::CalculateIndex(size_t x, size_t y, size_t z, size_t& index) noexcept
-{
-    if ((x > CHUNK_X) || (y > CHUNK_Y) || (z > CHUNK_Z))
-    {
-        LOG_W("Chunk coordinates [" << x << ", " << y << ", " << z
-              << "] exceed available Chunk dimensions! (which are ["
-              << CHUNK_X << ", " << CHUNK_Y << ", " << CHUNK_Z << "])");
-        return false;
-    }
-
-    // Convert 3D coordinates to a 1D array index. This way the one-dimensional array,
-    // which is easily accessible by Renderer, can be used as a 3D array.
-    index = x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
-    return true;
-}
-
-void Chunk::GenerateVBONaive()
+void Chunk::GenerateVBONaive(const ChunkNeighbours& neighbours)
 {
-    mVerts.clear();
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 0; y < CHUNK_Y / 4 + HEIGHTMAP_HEIGHT; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                VoxelType vox = GetVoxel(x, y, z);
-                if (vox != VoxelType::Air && vox != VoxelType::Unknown)
-                {
-                    // do some checks before adding a voxel to VBO
-                    // first of all, test only if we are not a bounding voxel chunk
-                    // otherwise we must add it anyway
-                    if ((x > 0) && (x < CHUNK_X - 1) &&
-                        (y > 0) && (y < CHUNK_Y - 1) &&
-                        (z > 0) && (z < CHUNK_Z - 1))
-                    {
-                        // Now see if there is VoxelType::Air in our neighbourhood
-                        // If it is, continue to add voxel to VBO. Otherwise, discard.
-                        VoxelType voxPlusX = GetVoxel(x+1, y, z);
-                        VoxelType voxMinusX = GetVoxel(x-1, y, z);
-                        VoxelType voxPlusY = GetVoxel(x, y+1, z);
-                        VoxelType voxMinusY = GetVoxel(x, y-1, z);
-                        VoxelType voxPlusZ = GetVoxel(x, y, z+1);
-                        VoxelType voxMinusZ = GetVoxel(x, y, z-1);
-
-                        if ((voxPlusX != VoxelType::Air) &&
-                            (voxMinusX != VoxelType::Air) &&
-                            (voxPlusY != VoxelType::Air) &&
-                            (voxMinusY != VoxelType::Air) &&
-                            (voxPlusZ != VoxelType::Air) &&
-                            (voxMinusZ != VoxelType::Air))
-                            // We are surrounded by voxels. Ergo, we are not visible.
-                            // Discard current voxel to not render unseen voxels.
-                            continue;
-                    }
-
-                    auto voxDataIt = VoxelDB.find(vox);
-                    if (voxDataIt == VoxelDB.end())
-                    {
-                        LOG_E("Voxel " << static_cast<VoxelUnderType>(vox)
-                              << " was not found in database!");
-                        continue;
-                    }
-
-                    mVerts.push_back(static_cast<float>(x));
-                    mVerts.push_back(static_cast<float>(y));
-                    mVerts.push_back(static_cast<float>(z));
-
-                    const Voxel& voxData = voxDataIt->second;
-                    mVerts.push_back(voxData.colorRed);
-                    mVerts.push_back(voxData.colorGreen);
-                    mVerts.push_back(voxData.colorBlue);
-                    mVerts.push_back(ALPHA_COMPONENT);
-                }
-            }
+    ChunkApron& apron = ChunkMesher::GetThreadScratch().apron;
+    BuildApron(neighbours, apron);
+    ChunkMesher::GenerateNaive(mVoxels.GetData(), mVerts, &apron);
+    std::vector<PackedVertex>().swap(mPackedVerts);
+    std::vector<CubeInstance>().swap(mCubeInstances);
     mMesh.SetPrimitiveType(MeshPrimitiveType::Points);
+    mMeshingMethod = MeshingMethod::Naive;
+    mFullUpload = true;
     // TODO Consider if this won't race with rest of the code
-    // If so check Chunk::Generate() and TerrainManager::Update()
+    // If so check Chunk::GenerateMesh() and TerrainManager::Update()
     mState = ChunkState::Generated;
-    mGreedyGenerated = false;
 }
 
-void Chunk::ProcessPlaneX(const VoxelType* voxels, const Vector& shift,
-                         std::vector<quad>& resultQuads)
+void Chunk::GenerateVBOInstanced(const ChunkNeighbours& neighbours)
 {
-    bool quadProcessing;
-    quad q;
-    for (int x = 0; x < CHUNK_X; ++x)
-        for (int y = 0; y < CHUNK_Y / 4 + HEIGHTMAP_HEIGHT; ++y)
-        {
-            // reset flags
-            quadProcessing = false;
-
-            for (int z = 0; z < CHUNK_Z; ++z)
-            {
-                size_t index;
-                CalculateIndex(x, y, z, index);
-                VoxelType vox = voxels[index];
-                if (vox != VoxelType::Air && vox != VoxelType::Unknown)
-                {
-                    // we found a voxel in this line that is not air!
-                    if (!quadProcessing)
-                    {
-                        // begin the processing, as this is the first one in this line
-                        q = {Vector(static_cast<float>(x),
-                                    static_cast<float>(y),
-                                    static_cast<float>(z), 0.0f) + shift,
-                             1, 1, vox};
-                        quadProcessing = true;
-                    }
-                    else
-                    {
-                        if (vox == q.v)
-                            // extend the quad that is already started (unless the voxel type matches)
-                            q.w++;
-                        else
-                        {
-                            // otherwise, close the quad and start a new one
-                            resultQuads.push_back(q);
-                            q = {Vector(static_cast<float>(x),
-                                        static_cast<float>(y),
-                                        static_cast<float>(z), 0.0f) + shift,
-                                 1, 1, vox};
-                        }
-                    }
-                }
-                else
-                {
-                    // we hit air during process, close the quad if it is being processed
-                    if (quadProcessing)
-                    {
-                        resultQuads.push_back(q);
-                        quadProcessing = false;
-                    }
-                }
-            }
-
-            if (quadProcessing)
-                // line finished during quad processing
-                // we can close the quad and push it back
-                resultQuads.push_back(q);
-        }
+    ChunkApron& apron = ChunkMesher::GetThreadScratch().apron;
+    BuildApron(neighbours, apron);
+    ChunkMesher::GenerateInstanced(mVoxels.GetData(), mCubeInstances, &apron);
+    std::vector<float>().swap(mVerts);
+    std::vector<PackedVertex>().swap(mPackedVerts);
+    mMesh.SetPrimitiveType(MeshPrimitiveType::Cubes);
+    mMeshingMethod = MeshingMethod::Instanced;
+    mFullUpload = true;
+    mState = ChunkState::Generated;
 }
 
-void Chunk::ProcessPlaneY(const VoxelType* voxels, const Vector& shift,
-                         std::vector<quad>& resultQuads)
+void Chunk::GenerateVBOGreedy(const ChunkNeighbours& neighbours)
 {
-    bool quadProcessing;
-    quad q;
-    for (int y = 0; y < CHUNK_Y / 4 + HEIGHTMAP_HEIGHT; ++y)
-        for (int z = 0; z < CHUNK_Z; ++z)
-        {
-            // reset flags
-            quadProcessing = false;
-
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                size_t index;
-                CalculateIndex(x, y, z, index);
-                VoxelType vox = voxels[index];
-                if (vox != VoxelType::Air && vox != VoxelType::Unknown)
-                {
-                    // we found a voxel in this line that is not air!
-                    if (!quadProcessing)
-                    {
-                        // begin the processing, as this is the first one in this line
-                        q = {Vector(static_cast<float>(x),
-                                    static_cast<float>(y),
-                                    static_cast<float>(z), 0.0f) + shift,
-                             1, 1, vox};
-                        quadProcessing = true;
-                    }
-                    else
-                    {
-                        if (vox == q.v)
-                            // extend the quad that is already started (unless the voxel type matches)
-                            q.w++;
-                        else
-                        {
-                            // otherwise, close the quad and start a new one
-                            resultQuads.push_back(q);
-                            q = {Vector(static_cast<float>(x),
-                                        static_cast<float>(y),
-                                        static_cast<float>(z), 0.0f) + shift,
-                                 1, 1, vox};
-                        }
-                    }
-                }
-                else
-                {
-                    // we hit air during process, close the quad if it is being processed
-                    if (quadProcessing)
-                    {
-                        resultQuads.push_back(q);
-                        quadProcessing = false;
-                    }
-                }
-            }
+    MeshingScratch& scratch = ChunkMesher::GetThreadScratch();
+    SectionRange sections[ChunkMesher::SECTION_COUNT];
+    unsigned char lod = mLod;
+    if (lod == 0)
+    {
+        BuildApron(neighbours, scratch.apron);
+        ChunkMesher::GenerateGreedy(mVoxels.GetData(), scratch.verts, &scratch.apron, sections);
+    }
+    else
+    {
+        // Neighbours might use another level, so nothing on the border is hidden
+        ChunkMesher::Downsample(mVoxels.GetData(), lod, scratch.lodVoxels.data());
+        ChunkMesher::GenerateGreedy(scratch.lodVoxels.data(), scratch.verts, nullptr, sections);
+        mMissingNeighbours = MISSING_X_PLUS | MISSING_X_MINUS | MISSING_Z_PLUS | MISSING_Z_MINUS;
+    }
 
-            if (quadProcessing)
-                // line finished during quad processing
-                // we can close the quad and push it back
-                resultQuads.push_back(q);
-        }
+    LayOutSections(scratch.verts, sections);
+    mMeshLod = lod;
+    std::vector<float>().swap(mVerts);
+    std::vector<CubeInstance>().swap(mCubeInstances);
+    mMesh.SetPrimitiveType(MeshPrimitiveType::Quads);
+    // Picked by CommitMeshUpdate() as soon as the state changes
+    mMeshingMethod = MeshingMethod::Greedy;
+    mFullUpload = true;
+    mState = ChunkState::Generated;
 }
 
-void Chunk::ProcessPlaneZ(const VoxelType* voxels, const Vector& shift,
-                         std::vector<quad>& resultQuads)
+MeshUpdateDesc Chunk::GetMeshUpdateDesc() noexcept
 {
-    bool quadProcessing;
-    quad q;
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 0; y < CHUNK_Y / 4 + HEIGHTMAP_HEIGHT; ++y)
-        {
-            // reset flags
-            quadProcessing = false;
-
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                size_t index;
-                CalculateIndex(x, y, z, index);
-                VoxelType vox = voxels[index];
-                if (vox != VoxelType::Air && vox != VoxelType::Unknown)
-                {
-                    // we found a voxel in this line that is not air!
-                    if (!quadProcessing)
-                    {
-                        // begin the processing, as this is the first one in this line
-                        q = {Vector(static_cast<float>(x),
-                                    static_cast<float>(y),
-                                    static_cast<float>(z), 0.0f) + shift,
-                             1, 1, vox};
-                        quadProcessing = true;
-                    }
-                    else
-                    {
-                        if (vox == q.v)
-                            // extend the quad that is already started (unless the voxel type matches)
-                            q.w++;
-                        else
-                        {
-                            // otherwise, close the quad and start a new one
-                            resultQuads.push_back(q);
-                            q = {Vector(static_cast<float>(x),
-                                        static_cast<float>(y),
-                                        static_cast<float>(z), 0.0f) + shift,
-                                 1, 1, vox};
-                        }
-                    }
-                }
-                else
-                {
-                    // we hit air during process, close the quad if it is being processed
-                    if (quadProcessing)
-                    {
-                        resultQuads.push_back(q);
-                        quadProcessing = false;
-                    }
-                }
-            }
-
-            if (quadProcessing)
-                // line finished during quad processing
-                // we can close the quad and push it back
-                resultQuads.push_back(q);
-        }
+    MeshUpdateDesc md;
+    switch (mMeshingMethod)
+    {
+    case MeshingMethod::Instanced:
+        // Instances take place of vertices, the cube itself is kept by Renderer
+        md.dataPtr = mCubeInstances.data();
+        md.dataSize = mCubeInstances.size() * sizeof(CubeInstance);
+        md.vertCount = mCubeInstances.size();
+        break;
+    case MeshingMethod::Greedy:
+        md.dataPtr = mPackedVerts.data();
+        md.dataSize = mPackedVerts.size() * sizeof(PackedVertex);
+        md.vertCount = mPackedVerts.size();
+        break;
+    default:
+        md.dataPtr = mVerts.data();
+        md.dataSize = mVerts.size() * sizeof(float);
+        md.vertCount = mVerts.size() / ChunkMesher::FLOAT_COUNT_PER_VERTEX_NAIVE;
+        break;
+    }
 
-    // TODO a further optimization might be joining same types of quads (matching start, w and v)
-    //      into one by increasing their height. Consider if this won't slow our GenerateVBOGreedy
-    //      too much.
+    return md;
 }
 
-void Chunk::PushVertsFromQuads(const std::vector<quad>& quads, const Vector& normal)
+void Chunk::LayOutSections(const std::vector<PackedVertex>& verts,
+                           const SectionRange* sections) noexcept
 {
-    Vector v0, v1, v2, v3;
+    size_t vertCount = 0;
+    for (int i = 0; i < ChunkMesher::SECTION_COUNT; ++i)
+    {
+        // Sections without faces are mostly air or buried underground, and stay so
+        size_t slotSize = sections[i].count ? sections[i].count + SECTION_SPARE_VERTS : 0;
+        mSectionSlots[i] = { vertCount, slotSize };
+        vertCount += slotSize;
+    }
 
-    for (const auto& q : quads)
+    mPackedVerts.resize(vertCount);
+    for (int i = 0; i < ChunkMesher::SECTION_COUNT; ++i)
     {
-        v0 = q.start;
-        // Shifting to match how Naive mesher expanded the verts to voxels.
-        if (normal[0] != 0.0f)
-        {
-            // Processing quads from X pass
-            v1 = q.start + Vector(0.0f, 0.0f, static_cast<float>(q.w), 0.0f);
-            v2 = q.start + Vector(0.0f, static_cast<float>(q.h), 0.0f, 0.0f);
-            v3 = q.start + Vector(0.0f, static_cast<float>(q.h), static_cast<float>(q.w), 0.0f);
-        }
-        else if (normal[1] != 0.0f)
-        {
-            // Processing quads from Y pass
-            v1 = q.start + Vector(static_cast<float>(q.w), 0.0f, 0.0f, 0.0f);
-            v2 = q.start + Vector(0.0f, 0.0f, static_cast<float>(q.h), 0.0f);
-            v3 = q.start + Vector(static_cast<float>(q.w), 0.0f, static_cast<float>(q.h), 0.0f);
-        }
-        else if (normal[2] != 0.0f)
-        {
-            // Processing quads from Z pass
-            v1 = q.start + Vector(static_cast<float>(q.w), 0.0f, 0.0f, 0.0f);
-            v2 = q.start + Vector(0.0f, static_cast<float>(q.h), 0.0f, 0.0f);
-            v3 = q.start + Vector(static_cast<float>(q.w), static_cast<float>(q.h), 0.0f, 0.0f);
-        }
+        auto slot = mPackedVerts.begin() + mSectionSlots[i].first;
+        auto sectionBegin = verts.begin() + sections[i].first;
+        slot = std::copy(sectionBegin, sectionBegin + sections[i].count, slot);
+        std::fill(slot, mPackedVerts.begin() + mSectionSlots[i].first + mSectionSlots[i].count,
+                  EMPTY_VERTEX);
+    }
+}
+
+bool Chunk::RemeshSection(int section, const ChunkApron& apron) noexcept
+{
+    MeshingScratch& scratch = ChunkMesher::GetThreadScratch();
+    ChunkMesher::GenerateGreedySection(mVoxels.GetData(), section, scratch.verts, &apron);
+    const SectionRange& slot = mSectionSlots[section];
+    if (scratch.verts.size() > slot.count)
+        return false;
 
-        auto voxDataIt = VoxelDB.find(q.v);
-        const Voxel& voxData = voxDataIt->second;
+    auto slotBegin = mPackedVerts.begin() + slot.first;
+    auto slotEnd = std::copy(scratch.verts.begin(), scratch.verts.end(), slotBegin);
+    std::fill(slotEnd, slotBegin + slot.count, EMPTY_VERTEX);
 
-        auto pushVerts = [this](const Vector& v, const Vector& n, const Voxel& vox) {
-            mVerts.push_back(v[0]); mVerts.push_back(v[1]); mVerts.push_back(v[2]);
-            mVerts.push_back(n[0]); mVerts.push_back(n[1]); mVerts.push_back(n[2]);
-            mVerts.push_back(vox.colorRed); mVerts.push_back(vox.colorGreen);
-            mVerts.push_back(vox.colorBlue); mVerts.push_back(ALPHA_COMPONENT);
-        };
+    if (mDirtyBegin < mDirtyEnd)
+    {
+        mDirtyBegin = std::min(mDirtyBegin, slot.first);
+        mDirtyEnd = std::max(mDirtyEnd, slot.first + slot.count);
+    }
+    else
+    {
+        mDirtyBegin = slot.first;
+        mDirtyEnd = slot.first + slot.count;
+    }
 
-        // Vert order: pos.xyz, norm.xyz, col.rgba
-        pushVerts(v0, normal, voxData); // first vert
+    return true;
+}
 
-        // Decide which order to take according to normals (they will help us
-        // select which side of the cube are we processing to set the vert order aka. tri strip)
-        // For some weird reason, the order was correct for all passes except for X pass.
-        // Instead of figuring out what is wrong, it is much easier to just fix a condition.
-        if ((normal[0] == 1.0f) || (normal[1] == -1.0f) || (normal[2] == -1.0f))
-        {
-            pushVerts(v2, normal, voxData); // third vert
-            pushVerts(v1, normal, voxData); // second vert
-            pushVerts(v1, normal, voxData); // second vert
-            pushVerts(v2, normal, voxData); // third vert
-        }
-        else
-        {
-            pushVerts(v1, normal, voxData); // second vert
-            pushVerts(v2, normal, voxData); // third vert
-            pushVerts(v2, normal, voxData); // third vert
-            pushVerts(v1, normal, voxData); // second vert
-        }
+const VoxelType* Chunk::GetApronVoxels(const Chunk* neighbour) noexcept
+{
+    // Neighbour's border facing us is final once it is decorated - only chunks, which are our
+    // neighbours as well, can place decorations there.
+    if (!neighbour || neighbour->GetState() < ChunkState::Decorated || neighbour->mLod != 0)
+        return nullptr;
 
-        pushVerts(v3, normal, voxData); // fourth vert
-    }
+    return neighbour->mVoxels.GetData();
 }
 
-void Chunk::GenerateVBOGreedy()
+void Chunk::BuildApron(const ChunkNeighbours& neighbours, ChunkApron& apron) noexcept
 {
-    VoxelType voxelsCulled[CHUNK_X * CHUNK_Y * CHUNK_Z];
-    for (auto& voxel : voxelsCulled)
-        voxel = VoxelType::Air;
+    const VoxelType* xPlus = GetApronVoxels(neighbours.xPlus);
+    const VoxelType* xMinus = GetApronVoxels(neighbours.xMinus);
+    const VoxelType* zPlus = GetApronVoxels(neighbours.zPlus);
+    const VoxelType* zMinus = GetApronVoxels(neighbours.zMinus);
+    ChunkMesher::BuildApron(xPlus, xMinus, zPlus, zMinus, apron);
+
+    mMissingNeighbours = 0;
+    if (!xPlus)
+        mMissingNeighbours |= MISSING_X_PLUS;
+    if (!xMinus)
+        mMissingNeighbours |= MISSING_X_MINUS;
+    if (!zPlus)
+        mMissingNeighbours |= MISSING_Z_PLUS;
+    if (!zMinus)
+        mMissingNeighbours |= MISSING_Z_MINUS;
+}
 
-    mVerts.clear();
-    // First stage of greedy meshing - cull invisible voxels like in Naive alg
-    for (int z = 0; z < CHUNK_Z; ++z)
-        for (int y = 0; y < CHUNK_Y / 4 + HEIGHTMAP_HEIGHT; ++y)
-            for (int x = 0; x < CHUNK_X; ++x)
-            {
-                VoxelType vox = GetVoxel(x, y, z);
-                if (vox != VoxelType::Air && vox != VoxelType::Unknown)
-                {
-                    // First of all, test only if we are not a bounding voxel chunk.
-                    // Otherwise we must add the voxel anyway.
-                    if ((x > 0) && (x < CHUNK_X - 1) &&
-                        (y > 0) && (y < CHUNK_Y - 1) &&
-                        (z > 0) && (z < CHUNK_Z - 1))
-                    {
-                        // Now see if there is VoxelType::Air in our neighbourhood
-                        // If there is none, discard the Voxel.
-                        VoxelType voxPlusX = GetVoxel(x+1, y, z);
-                        VoxelType voxMinusX = GetVoxel(x-1, y, z);
-                        VoxelType voxPlusY = GetVoxel(x, y+1, z);
-                        VoxelType voxMinusY = GetVoxel(x, y-1, z);
-                        VoxelType voxPlusZ = GetVoxel(x, y, z+1);
-                        VoxelType voxMinusZ = GetVoxel(x, y, z-1);
-
-                        if ((voxPlusX != VoxelType::Air) &&
-                            (voxMinusX != VoxelType::Air) &&
-                            (voxPlusY != VoxelType::Air) &&
-                            (voxMinusY != VoxelType::Air) &&
-                            (voxPlusZ != VoxelType::Air) &&
-                            (voxMinusZ != VoxelType::Air))
-                            // We are surrounded by voxels. Ergo, we are not visible.
-                            // Discard current voxel to not render unseen voxels.
-                            continue;
-                    }
-
-                    size_t index;
-                    CalculateIndex(x, y, z, index);
-                    voxelsCulled[index] = vox;
-                }
-            }
+bool Chunk::NeedsSideRemesh(unsigned char side, const Chunk* neighbour) const noexcept
+{
+    if (mMissingNeighbours & side)
+        return GetApronVoxels(neighbour) != nullptr;
 
-    // With culled Mesh, we have to do six passes now. two per each axis.
-    std::vector<quad> quadsXPlus;
-    std::vector<quad> quadsXMinus;
-    std::vector<quad> quadsYPlus;
-    std::vector<quad> quadsYMinus;
-    std::vector<quad> quadsZPlus;
-    std::vector<quad> quadsZMinus;
-
-    // All shifts are by +/- 0.5f to match the behavior of Naive generator
-    ProcessPlaneX(voxelsCulled, Vector( 0.5f,-0.5f,-0.5f, 0.0f), quadsXPlus);
-    ProcessPlaneX(voxelsCulled, Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsXMinus);
-    ProcessPlaneY(voxelsCulled, Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsYPlus);
-    ProcessPlaneY(voxelsCulled, Vector(-0.5f, 0.5f,-0.5f, 0.0f), quadsYMinus);
-    ProcessPlaneZ(voxelsCulled, Vector(-0.5f,-0.5f, 0.5f, 0.0f), quadsZPlus);
-    ProcessPlaneZ(voxelsCulled, Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsZMinus);
-
-    // Push the quads and build a Mesh from it
-    PushVertsFromQuads(quadsXPlus,  Vector( 1.0f, 0.0f, 0.0f, 0.0f));
-    PushVertsFromQuads(quadsXMinus, Vector(-1.0f, 0.0f, 0.0f, 0.0f));
-    PushVertsFromQuads(quadsYPlus,  Vector( 0.0f, 1.0f, 0.0f, 0.0f));
-    PushVertsFromQuads(quadsYMinus, Vector( 0.0f,-1.0f, 0.0f, 0.0f));
-    PushVertsFromQuads(quadsZPlus,  Vector( 0.0f, 0.0f, 1.0f, 0.0f));
-    PushVertsFromQuads(quadsZMinus, Vector( 0.0f, 0.0f,-1.0f, 0.0f));
-
-    mMesh.SetPrimitiveType(MeshPrimitiveType::Triangles);
-    mState = ChunkState::Generated;
-    mGreedyGenerated = true;
+    // Neighbour switched to a coarser level - faces it hid are visible through the gaps
+    return neighbour && neighbour->mLod != 0;
 }
 
-bool Chunk::SaveToDisk()
+bool Chunk::SaveToDisk(ChunkCompression compression)
 {
     // Check if there is data to save
     if (NeedsGeneration())
@@ -674,89 +499,17 @@ bool Chunk::SaveToDisk()
     if (!FS::IsDir("./" + CHUNK_DIR))
         FS::CreateDir("./" + CHUNK_DIR);
 
-    std::fstream file;
-
     // Construct filename
-    std::string fileName(CHUNK_DIR + "/Chunk_" + std::to_string(mCoordX) + '_'
-                         + std::to_string(mCoordZ) + CHUNK_FILEEXT);
-
-    file.open(fileName, std::ios::out | std::ios::trunc);
-
-    if (file.is_open())
-    {
-        VoxelType tempVox = mVoxels[0];
-        VoxelType lastVox;
-        uint32_t counter;
-        for (int i = 0; i < CHUNK_X * CHUNK_Y * CHUNK_Z; )
-        {
-            lastVox = tempVox;
-            counter = 1;
-            i++;
-
-            while (lastVox == tempVox && i < CHUNK_X * CHUNK_Y * CHUNK_Z)
-            {
-                counter++;
-                tempVox = mVoxels[i++];
-            }
-
-            if (i < CHUNK_X * CHUNK_Y * CHUNK_Z)
-            {
-                counter--;
-                i--;
-            }
-
-            file << counter;
-            file << static_cast<VoxelUnderType>(lastVox);
-
-            if (!file)
-            {
-                LOG_E("Writing to file \"" << fileName << "\" failed.");
-                return false;
-            }
-        }
-
-        file.close();
-        return true;
-    } else
-    {
-        LOG_E("Failed to open file \"" << fileName << "\" for writing.");
-        return false;
-    }
+    std::string fileName(CHUNK_DIR + '/' + ChunkManifest::GetChunkFileName(mCoordX, mCoordZ));
+    return mVoxels.SaveToFile(fileName, compression);
 }
 
 bool Chunk::LoadFromDisk()
 {
-    std::fstream file;
-
     // Construct filename
-    std::string fileName(CHUNK_DIR + "/Chunk_" + std::to_string(mCoordX) + '_'
-                         + std::to_string(mCoordZ) + CHUNK_FILEEXT);
-
-    file.open(fileName, std::ios::in);
-
-    if (file.is_open())
-    {
-        VoxelUnderType tempVox;
-        uint32_t counter;
-        for (int i = 0; i < CHUNK_X * CHUNK_Y * CHUNK_Z; )
-        {
-            file >> counter;
-            file >> tempVox;
+    std::string fileName(CHUNK_DIR + '/' + ChunkManifest::GetChunkFileName(mCoordX, mCoordZ));
 
-            do
-            {
-                counter--;
-                mVoxels[i++] = static_cast<VoxelType>(tempVox);
-            } while (counter && i < CHUNK_X * CHUNK_Y * CHUNK_Z);
-
-            if (!file)
-                return false;
-        }
-
-        file.close();
-        return true;
-    } else
-        return false;
+    return mVoxels.LoadFromFile(fileName);
 }
 
 bool Chunk::ChunkRayIntersection(Vector pos, Vector dir, float &distance, Vector &coords)
@@ -10,39 +10,58 @@
 #include <cstddef>
 #include <vector>
 #include <atomic>
-#include <functional>
+#include <string>
 
+#include "Defines.hpp"
 #include "Voxel.hpp"
+#include "ChunkManifest.hpp"
+#include "ChunkMesher.hpp"
+#include "ChunkSerializer.hpp"
+#include "ChunkVoxels.hpp"
+#include "Decoration.hpp"
+#include "TerrainGenerator.hpp"
 #include "Renderer/Mesh.hpp"
 
 /**
- * Chunk dimensions.
- * Will be useful when measuring performance between specific chunk sizes.
+ * Lifecycle of a Chunk. States only advance, in order of declaration.
  */
-#define CHUNK_X 32
-#define CHUNK_Y 128
-#define CHUNK_Z 32
-
 enum class ChunkState: unsigned char
 {
-    NotGenerated = 0,
-    Generated,
-    Updated
+    NotGenerated = 0,   ///< Chunk holds no valid voxels.
+    TerrainGenerated,   ///< Terrain was generated or loaded, decorations were not placed yet.
+    Decorated,          ///< Chunk placed its decorations. Neighbours still might add theirs.
+    Generated,          ///< Mesh was built and waits to be committed.
+    Updated             ///< Mesh was committed and can be rendered.
 };
 
-struct ChunkDesc
+/**
+ * Ways of turning Chunk's voxels into a Mesh.
+ */
+enum class MeshingMethod: unsigned char
 {
-    std::string chunkPath;          ///< Path to current save directory with chunk data.
-    std::string chunkFileExt;       ///< File extension for chunk files.
+    Naive = 0,  ///< Point per voxel, expanded to a cube by Geometry Shader.
+    Instanced,  ///< Instance per voxel, drawn with a single static cube Mesh.
+    Greedy      ///< Faces merged into large quads.
 };
 
-struct quad
+class Chunk;
+
+/**
+ * Chunks bordering a Chunk from its four sides, nullptr if not present in ChunkPool.
+ */
+struct ChunkNeighbours
 {
-    Vector start; // starting points
-    int w, h; // width and height
-    VoxelType v; // type of voxel to which the quad belongs
+    const Chunk* xPlus;     ///< Chunk [X + 1, Z].
+    const Chunk* xMinus;    ///< Chunk [X - 1, Z].
+    const Chunk* zPlus;     ///< Chunk [X, Z + 1].
+    const Chunk* zMinus;    ///< Chunk [X, Z - 1].
 };
 
+struct ChunkDesc
+{
+    std::string chunkPath;          ///< Path to current save directory with chunk data.
+    std::string chunkFileExt;       ///< File extension for chunk files.
+};
 
 class Chunk
 {
@@ -125,19 +144,145 @@ public:
     void Shift(int chunkX, int chunkZ);
 
     /**
-     * Fills the Chunk with Perlin-generated voxels.
+     * Fills the Chunk with Perlin-generated voxels and switches it to "TerrainGenerated" state.
      *
-     * @param chunkX            Number of X-th chunk in the generated world, relative to currentChunkX.
-     * @param chunkZ            Number of Z-th chunk in the generated world, relative to currentChunkZ.
-     * @param currentChunkX     Number of X-th chunk on which player currently is.
-     * @param currentChunkZ     Number of Z-th chunk on which player currently is.
-     * @param useGreedyMeshing  False to use naive meshing, true to use greedy meshing.
+     * @param coordX     Chunk's X coordinate in the world.
+     * @param coordZ     Chunk's Z coordinate in the world.
+     * @param generator  Generator used to fill the Chunk with voxels.
+     * @param manifest   Manifest of chunks saved on disk.
+     * @param decoration Queue the Chunk is attached to once its terrain is complete. Decorations
+     *                   of neighbours, which were placed before, are applied at this point.
      *
      * The chunks in the world create a two-dimensional grid. All are connected and it is assumed,
      * that the map generated in between them is seamless.
+     *
+     * Chunk is loaded from disk instead of being generated, if @p manifest reports it might have
+     * been saved before. Otherwise, disk is not touched at all.
+     */
+    void GenerateTerrain(int coordX, int coordZ, const TerrainGenerator& generator,
+                         const ChunkManifest& manifest, DecorationQueue& decoration) noexcept;
+
+    /**
+     * Places decorations rooted in the Chunk and switches it to "Decorated" state.
+     *
+     * @param generator  Generator used to fill the Chunk with voxels.
+     * @param decoration Queue the Chunk was attached to by GenerateTerrain().
+     *
+     * Decorations reach into neighbouring chunks, so it should be called only once all eight
+     * neighbours are terrain-complete. Otherwise their part of decorations waits in @p decoration
+     * until they are.
+     *
+     * Chunks loaded from disk already contain their decorations, but are decorated again anyway.
+     * Decorations are deterministic and placing them twice changes nothing, while neighbours,
+     * which were not saved, get their part of decorations back.
+     */
+    void Decorate(const TerrainGenerator& generator, DecorationQueue& decoration) noexcept;
+
+    /**
+     * Builds Chunk's Mesh and switches it to "Generated" state.
+     *
+     * @param method     Method used to build the Mesh.
+     * @param neighbours Chunks bordering this one. Faces hidden by their voxels are left out of
+     *                   the Mesh.
+     *
+     * To avoid rebuilding the Mesh, it should be called only when the Chunk and all eight of its
+     * neighbours are decorated - only then Chunk's voxels are final.
+     */
+    void GenerateMesh(MeshingMethod method, const ChunkNeighbours& neighbours) noexcept;
+
+    /**
+     * Rebuilds parts of the Mesh affected by a change of voxel [@p x, @p y, @p z] and switches
+     * the Chunk to "Generated" state.
+     *
+     * @param x, y, z          Coordinates of the changed voxel. They may lie one voxel outside
+     *                         of the Chunk, when the voxel belongs to a neighbour.
+     * @param method           Method used to build the Mesh.
+     * @param neighbours       Chunks bordering this one.
+     *
+     * Greedy Mesh is rebuilt only in sections containing the voxel or bordering it, and only
+     * their vertices are uploaded by CommitMeshUpdate(). Other Meshes are rebuilt as a whole.
+     * Currently committed Mesh is rendered until then.
+     *
+     * @remarks Chunk must already have a Mesh and must be reserved with ReserveTask(), just like
+     * for GenerateMesh(). Reservation is released once done.
+     */
+    void RemeshAround(int x, int y, int z, MeshingMethod method,
+                      const ChunkNeighbours& neighbours) noexcept;
+
+    /**
+     * Checks if any neighbour, which was missing or not yet decorated when the Mesh was built, is
+     * now available. Faces on the Chunk's border with such neighbour were kept, so rebuilding
+     * the Mesh will hide some of them.
+     *
+     * Neighbours with a coarser level of detail count as missing, as their Mesh does not match
+     * their voxels. Faces towards them are kept to cover the gaps, so the Mesh is rebuilt also
+     * when a neighbour switches to a coarser level.
+     *
+     * @param neighbours Chunks currently bordering this one.
+     * @return Always false for a coarse Mesh, which keeps all faces on the border anyway.
+     *
+     * @remarks Mesh state is written by meshing tasks, so the Chunk must not be reserved, see
+     * IsTaskReserved().
+     */
+    bool NeedsBorderRemesh(const ChunkNeighbours& neighbours) const noexcept;
+
+    /**
+     * Returns whether the Mesh was built without some of the neighbours. Just like
+     * NeedsBorderRemesh(), the Chunk must not be reserved.
+     */
+    bool HasMissingNeighbours() const noexcept;
+
+    /**
+     * Sets level of detail of the greedy Mesh built from now on.
+     *
+     * @param lod Level, from 0 (full resolution) to ChunkMesher::LOD_LEVEL_COUNT - 1. Level N
+     *            merges blocks of 2^N voxels in every axis, see ChunkMesher::Downsample().
+     *
+     * Current Mesh is kept, NeedsLodRemesh() tells whether it has to be rebuilt.
+     */
+    void SetLod(unsigned int lod) noexcept;
+
+    /**
+     * Acquire level of detail set by SetLod().
+     */
+    unsigned int GetLod() const noexcept;
+
+    /**
+     * Returns whether the greedy Mesh was built with another level of detail than currently set.
+     * Just like NeedsBorderRemesh(), the Chunk must not be reserved.
+     */
+    bool NeedsLodRemesh() const noexcept;
+
+    /**
+     * Reserves the Chunk for a single generator task, advancing it from @p state.
+     *
+     * @param state State the task expects the Chunk to be in.
+     * @return True if the Chunk was reserved. False if another task was already scheduled and has
+     * not finished yet, or the Chunk is not in @p state.
+     *
+     * Reservation is released when GenerateTerrain(), Decorate(), GenerateMesh() or
+     * RemeshAround() is done. Tasks change the state before that, so a Chunk is never scheduled
+     * twice for the same work.
+     */
+    bool ReserveTask(ChunkState state) noexcept;
+
+    /**
+     * Returns whether a task reserved with ReserveTask() has not finished yet.
+     *
+     * Once false, everything written by the last task is visible to the caller.
+     */
+    bool IsTaskReserved() const noexcept;
+
+    /**
+     * Acquire current state of Chunk's lifecycle.
+     */
+    ChunkState GetState() const noexcept;
+
+    /**
+     * Acquire Chunk's coordinates in the world, as set by GenerateTerrain().
      */
-    void Generate(int chunkX, int chunkZ, int currentChunkX, int currentChunkZ,
-                  bool useGreedyMeshing) noexcept;
+    int GetCoordX() const noexcept;
+    int GetCoordZ() const noexcept;
 
     /**
      * Acquire pointer to a Mesh object managed by Chunk.
@@ -146,18 +291,13 @@ public:
 
     /**
      * Commits update to Mesh object. As a result, Chunk will switch itself to "Updated" state and
-     * Mesh object will become unlocked to use for Renderer.
+     * Mesh object will become unlocked to use for Renderer. After RemeshAround() only vertices
+     * of rebuilt sections are uploaded.
      *
      * @remarks This call triggers OpenGL calls. It must be called by main rendering thread.
      */
     void CommitMeshUpdate();
 
-    /**
-     * Sets a Chunk to be in a "not generated" state, locks Chunk's Mesh to withhold it from
-     * rendering.
-     */
-    void ResetState() noexcept;
-
     /**
      * Returns whether the mesh has finished generation and is ready to commit the changes to
      * Mesh object.
@@ -182,12 +322,13 @@ public:
     /**
      * Writes Chunk's voxel data to disk.
      *
+     * @param compression Compression method used for saved data.
      * @return True, if writing was successfull. False otherwise.
      *
      * @remarks Chunk needs to be generated beforehand. Otherwise this function
      * will fail.
      */
-    bool SaveToDisk();
+    bool SaveToDisk(ChunkCompression compression);
 
     /**
      * Checks intersection with every non-air voxel in the chunk
@@ -202,7 +343,8 @@ public:
     bool ChunkRayIntersection(Vector pos, Vector dir, float &distance, Vector &coords);
 
     /**
-     * Generates a VBO from current state of mVoxels array using naive method.
+     * Generates a VBO from current state of mVoxels using naive method. Voxels hidden by
+     * @p neighbours are left out.
      *
      * Created Mesh will contain a cloud of points, which shall be evolved into triangles
      * by Geometry Shader.
@@ -211,81 +353,108 @@ public:
      * it is mostly used for debugging purposes. Release code should contain Chunk Mesh
      * generated using Chunk::GenerateVBOGreedy().
      */
-    void GenerateVBONaive();
+    void GenerateVBONaive(const ChunkNeighbours& neighbours);
+
+    /**
+     * Generates a VBO from current state of mVoxels with a cube instance per voxel. Voxels and
+     * faces hidden by @p neighbours are left out.
+     *
+     * Keeps the same voxels as Chunk::GenerateVBONaive(), but the Mesh is drawn by instancing
+     * a static cube, with no Geometry Shader.
+     */
+    void GenerateVBOInstanced(const ChunkNeighbours& neighbours);
 
     /**
-     * Generates a VBO from current state of mVoxels array using Greedy Meshing algorithm.
+     * Generates a VBO from current state of mVoxels using Greedy Meshing algorithm. Faces hidden by
+     * @p neighbours are left out.
      *
      * Created Mesh will contain a typical triangle mesh. No Geometry Shader work is needed
      * to render the Chunk, giving us more GPU workload for graphical effects.
+     *
+     * With a level of detail above 0, the Mesh is built from downsampled voxels and ignores
+     * @p neighbours. Faces on the border are kept as skirts hiding gaps between levels.
      */
-    void GenerateVBOGreedy();
+    void GenerateVBOGreedy(const ChunkNeighbours& neighbours);
 
 private:
     /**
-     * Translates three coordinates to a single index inside mVoxels array. Additionally checks if
-     * coordinates are correct and returns an error if they exceed mVoxels dimensions.
-     *
-     * @param [in]  x     X coordinate inside voxel array.
-     * @param [in]  y     Y coordinate inside voxel array.
-     * @param [in]  z     Z coordinate inside voxel array.
-     * @param [out] index Index inside mVoxels array.
-     * @return True on success, false if index has exceeded the bounds of mVoxels array.
-     *
-     * @remarks For performance the function assumes there will be no exception thrown. Error is
-     * reported through return value to propagate it further to public methods of Chunk.
+     * Describes vertices of the last generated Mesh for upload.
      */
-    bool CalculateIndex(size_t x, size_t y, size_t z, size_t& index) noexcept;
+    MeshUpdateDesc GetMeshUpdateDesc() noexcept;
 
     /**
-     * Checks intersection with single OBB
-     *
-     * @param pos              Ray origin, in world space.
-     * @param dir              Ray direction, in world space. Must be normalized!
-     * @param obb_min          Minimum X,Y,Z coords of the mesh when not transformed at all
-     * @param obb_max          Maximum X,Y,Z coords of the mesh when not transformed at all
-     * @param worldMat         Transformation applied to the mesh
-     * @param intersectionDist Output : distance between @p pos and the intersection with the OBB
+     * Copies greedy vertices of all sections from @p verts to mPackedVerts, leaving spare
+     * vertices after each section, so it can grow a bit without moving other sections.
+     */
+    void LayOutSections(const std::vector<PackedVertex>& verts,
+                        const SectionRange* sections) noexcept;
+
+    /**
+     * Rebuilds greedy vertices of sections affected by a change of voxel [@p x, @p y, @p z], see
+     * RemeshAround().
+     */
+    void RemeshSections(int x, int y, int z, const ChunkNeighbours& neighbours) noexcept;
+
+    /**
+     * Rebuilds greedy vertices of a single @p section in place, using @p apron built once for all
+     * sections rebuilt by RemeshSections().
      *
-     * @return True, if intersection was found. False otherwise.
+     * @return False if the section does not fit its slot anymore and the whole Mesh has to be
+     * laid out again.
      */
-    bool OBBRayIntersection(Vector pos, Vector dir, Vector obb_min, Vector obb_max,
-                            Matrix worldMat, float& intersectionDist);
+    bool RemeshSection(int section, const ChunkApron& apron) noexcept;
 
     /**
-     * Processes Chunk from X plane perspective.
+     * Acquire voxels of @p neighbour to be used in an apron, or nullptr if there is no neighbour,
+     * its voxels are not complete yet or its Mesh has a coarser level of detail.
      */
-    void ProcessPlaneX(const VoxelType* voxels, const Vector& shift,
-                       std::vector<quad>& resultQuads);
+    static const VoxelType* GetApronVoxels(const Chunk* neighbour) noexcept;
 
     /**
-     * Processes Chunk from Y plane perspective.
+     * Copies voxels bordering the Chunk from @p neighbours to @p apron and remembers which
+     * neighbours were missing.
      */
-    void ProcessPlaneY(const VoxelType* voxels, const Vector& shift,
-                       std::vector<quad>& resultQuads);
+    void BuildApron(const ChunkNeighbours& neighbours, ChunkApron& apron) noexcept;
 
     /**
-     * Processes Chunk from Z plane perspective.
+     * Checks if faces on the border with @p neighbour, marked by @p side bit of
+     * mMissingNeighbours, are not up to date anymore. See NeedsBorderRemesh().
      */
-    void ProcessPlaneZ(const VoxelType* voxels, const Vector& shift,
-                       std::vector<quad>& resultQuads);
+    bool NeedsSideRemesh(unsigned char side, const Chunk* neighbour) const noexcept;
 
     /**
-     * Pushes generated quads to mVerts array
+     * Checks intersection with single OBB
+     *
+     * @param pos              Ray origin, in world space.
+     * @param dir              Ray direction, in world space. Must be normalized!
+     * @param obb_min          Minimum X,Y,Z coords of the mesh when not transformed at all
+     * @param obb_max          Maximum X,Y,Z coords of the mesh when not transformed at all
+     * @param worldMat         Transformation applied to the mesh
+     * @param intersectionDist Output : distance between @p pos and the intersection with the OBB
+     *
+     * @return True, if intersection was found. False otherwise.
      */
-    void PushVertsFromQuads(const std::vector<quad>& quads, const Vector& normal);
+    bool OBBRayIntersection(Vector pos, Vector dir, Vector obb_min, Vector obb_max,
+                            Matrix worldMat, float& intersectionDist);
 
     /**
-     * 1D Array of voxels, which represent a single chunk.
+     * Voxels, which represent a single chunk.
      */
-    VoxelType mVoxels[CHUNK_X * CHUNK_Y * CHUNK_Z];
-    std::vector<float> mVerts;
+    ChunkVoxels mVoxels;
+    std::vector<float> mVerts;                  ///< Vertices of naive Mesh.
+    std::vector<PackedVertex> mPackedVerts;     ///< Vertices of greedy Mesh.
+    std::vector<CubeInstance> mCubeInstances;   ///< Instances of instanced Mesh.
+    SectionRange mSectionSlots[ChunkMesher::SECTION_COUNT]; ///< Sections' parts of mPackedVerts.
     Mesh mMesh;
     std::atomic<ChunkState> mState;
+    std::atomic<bool> mTaskReserved;
     int mCoordX, mCoordZ;
-    bool mGreedyGenerated;
-    std::function<void()> mTerrainGenerator;
-    int mFloatCountPerVertex;
+    MeshingMethod mMeshingMethod;       ///< Method used to build current Mesh.
+    std::atomic<unsigned char> mLod;    ///< Level of detail of the next greedy Mesh.
+    unsigned char mMeshLod;             ///< Level of detail of the current greedy Mesh.
+    unsigned char mMissingNeighbours;   ///< Sides without apron during last meshing, bit set.
+    bool mFullUpload;                   ///< Whole Mesh changed since last commit.
+    size_t mDirtyBegin, mDirtyEnd;      ///< Greedy vertices changed since last commit.
 };
 
 #endif // __TERRAIN_CHUNK_HPP__
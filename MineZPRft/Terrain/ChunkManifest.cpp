@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Manifest definitions.
+ */
+
+#include "ChunkManifest.hpp"
+
+#include "Common/FileSystem.hpp"
+#include "Common/Logger.hpp"
+
+#include <cstdlib>
+
+namespace
+{
+
+const std::string CHUNK_FILEPREFIX = "Chunk_";
+const std::string CHUNK_FILEEXT = ".riQrll";
+
+// SplitMix64 finalizer - spreads neighbouring coordinates evenly over the filter
+uint64_t MixBits(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+// Parse a signed integer from [begin, end) range. Whole range must be consumed.
+bool ParseInt(const std::string& str, size_t begin, size_t end, int& result)
+{
+    if (begin >= end)
+        return false;
+
+    std::string number = str.substr(begin, end - begin);
+    char* numberEnd = nullptr;
+    long value = std::strtol(number.c_str(), &numberEnd, 10);
+    if (*numberEnd != '\0')
+        return false;
+
+    result = static_cast<int>(value);
+    return true;
+}
+
+} // namespace
+
+
+ChunkManifest::ChunkManifest()
+{
+    Clear();
+}
+
+void ChunkManifest::Build(const std::string& dir)
+{
+    Clear();
+
+    int x, z;
+    for (const auto& file : FS::ListFiles(dir))
+        if (ParseChunkFileName(file, x, z))
+            Add(x, z);
+
+    LOG_I("Chunk manifest built, " << GetEntryCount() << " saved chunks found in '"
+          << dir << "'");
+}
+
+void ChunkManifest::Clear() noexcept
+{
+    for (auto& word : mWords)
+        word.store(0, std::memory_order_relaxed);
+    mEntryCount = 0;
+}
+
+void ChunkManifest::Add(int x, int z) noexcept
+{
+    uint32_t bits[HASH_COUNT];
+    CalculateBits(x, z, bits);
+
+    for (uint32_t bit : bits)
+        mWords[bit / WORD_BITS].fetch_or(1u << (bit % WORD_BITS), std::memory_order_relaxed);
+
+    mEntryCount++;
+}
+
+bool ChunkManifest::MayContain(int x, int z) const noexcept
+{
+    uint32_t bits[HASH_COUNT];
+    CalculateBits(x, z, bits);
+
+    for (uint32_t bit : bits)
+        if (!(mWords[bit / WORD_BITS].load(std::memory_order_relaxed) & (1u << (bit % WORD_BITS))))
+            return false;
+
+    return true;
+}
+
+size_t ChunkManifest::GetEntryCount() const noexcept
+{
+    return mEntryCount;
+}
+
+std::string ChunkManifest::GetChunkFileName(int x, int z)
+{
+    return CHUNK_FILEPREFIX + std::to_string(x) + '_' + std::to_string(z) + CHUNK_FILEEXT;
+}
+
+bool ChunkManifest::ParseChunkFileName(const std::string& name, int& x, int& z)
+{
+    if (name.size() <= CHUNK_FILEPREFIX.size() + CHUNK_FILEEXT.size())
+        return false;
+
+    if (name.compare(0, CHUNK_FILEPREFIX.size(), CHUNK_FILEPREFIX) != 0)
+        return false;
+
+    size_t extPos = name.size() - CHUNK_FILEEXT.size();
+    if (name.compare(extPos, CHUNK_FILEEXT.size(), CHUNK_FILEEXT) != 0)
+        return false;
+
+    // Separator is searched from the second character, so negative X coordinate is handled
+    size_t separator = name.find('_', CHUNK_FILEPREFIX.size() + 1);
+    if (separator == std::string::npos || separator >= extPos)
+        return false;
+
+    return ParseInt(name, CHUNK_FILEPREFIX.size(), separator, x) &&
+           ParseInt(name, separator + 1, extPos, z);
+}
+
+void ChunkManifest::CalculateBits(int x, int z, uint32_t (&bits)[HASH_COUNT]) const noexcept
+{
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+                   static_cast<uint32_t>(z);
+    uint64_t hash = MixBits(key);
+
+    // Double hashing - derive all indices from two halves of a single 64-bit hash
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (size_t i = 0; i < HASH_COUNT; ++i)
+        bits[i] = (h1 + static_cast<uint32_t>(i) * h2) % CHUNK_MANIFEST_BITS;
+}
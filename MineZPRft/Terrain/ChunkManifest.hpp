@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Manifest declaration.
+ */
+
+#ifndef __TERRAIN_CHUNKMANIFEST_HPP__
+#define __TERRAIN_CHUNKMANIFEST_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Size of manifest's bloom filter. 2^16 bits (8 KiB) keep false positive rate below 1% for
+ * several thousands of saved chunks.
+ */
+#define CHUNK_MANIFEST_BITS (1 << 16)
+
+/**
+ * A compact set of chunk coordinates, which were saved to disk.
+ *
+ * Manifest is built once on startup by scanning the chunk directory and is kept up to date by
+ * every successful save. It is backed by a bloom filter, so the answer "chunk might be on disk"
+ * can be a false positive, but "chunk is not on disk" is always correct. This way generator can
+ * skip opening files for chunks which were never saved.
+ *
+ * All methods are lock-free and can be called from generator threads and main thread at once.
+ */
+class ChunkManifest
+{
+public:
+    ChunkManifest();
+
+    /**
+     * Rebuild manifest from contents of @p dir.
+     *
+     * @param dir Directory with chunk files.
+     *
+     * Files which do not follow chunk naming scheme are ignored. If @p dir does not exist, the
+     * manifest is left empty.
+     */
+    void Build(const std::string& dir);
+
+    /**
+     * Remove all entries from manifest.
+     */
+    void Clear() noexcept;
+
+    /**
+     * Mark chunk [@p x, @p z] as saved on disk.
+     */
+    void Add(int x, int z) noexcept;
+
+    /**
+     * Check if chunk [@p x, @p z] might be saved on disk.
+     *
+     * @return False if chunk was surely never saved. True if it probably was.
+     */
+    bool MayContain(int x, int z) const noexcept;
+
+    /**
+     * Acquire amount of chunks added to manifest.
+     */
+    size_t GetEntryCount() const noexcept;
+
+    /**
+     * Construct a file name (without directory) for chunk [@p x, @p z].
+     */
+    static std::string GetChunkFileName(int x, int z);
+
+    /**
+     * Extract chunk coordinates from file name created by GetChunkFileName().
+     *
+     * @return True if @p name is a valid chunk file name, false otherwise.
+     */
+    static bool ParseChunkFileName(const std::string& name, int& x, int& z);
+
+private:
+    static const size_t HASH_COUNT = 3;
+    static const size_t WORD_BITS = 32;
+    static const size_t WORD_COUNT = CHUNK_MANIFEST_BITS / WORD_BITS;
+
+    void CalculateBits(int x, int z, uint32_t (&bits)[HASH_COUNT]) const noexcept;
+
+    std::atomic<uint32_t> mWords[WORD_COUNT];
+    std::atomic<size_t> mEntryCount;
+};
+
+#endif // __TERRAIN_CHUNKMANIFEST_HPP__
@@ -0,0 +1,641 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Mesher definitions.
+ */
+
+#include "ChunkMesher.hpp"
+
+#include "Common/Logger.hpp"
+
+#include <algorithm>
+
+namespace
+{
+const float ALPHA_COMPONENT = 1.0f; // Alpha color component should stay at 1,0 (full opacity).
+
+size_t VoxelIndex(int x, int y, int z)
+{
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+// Index of @p normal, as expected by MainVS.glsl
+unsigned char GetNormalIndex(const Vector& normal)
+{
+    for (unsigned char axis = 0; axis < 3; ++axis)
+        if (normal[axis] != 0.0f)
+            return axis * 2 + (normal[axis] < 0.0f ? 1 : 0);
+
+    return 0;
+}
+
+bool IsSolid(VoxelType voxel)
+{
+    return voxel != VoxelType::Air && voxel != VoxelType::Unknown;
+}
+
+// Voxels [begin, end) along each axis
+struct VoxelBox
+{
+    int begin[3];
+    int end[3];
+};
+
+VoxelBox GetSectionBox(int section)
+{
+    const int size = ChunkMesher::SECTION_SIZE;
+    int x = section / (ChunkMesher::SECTION_COUNT_Y * ChunkMesher::SECTION_COUNT_Z);
+    int y = section / ChunkMesher::SECTION_COUNT_Z % ChunkMesher::SECTION_COUNT_Y;
+    int z = section % ChunkMesher::SECTION_COUNT_Z;
+    VoxelBox box = {{ x * size, y * size, z * size },
+                    { (x + 1) * size, (y + 1) * size, (z + 1) * size }};
+    return box;
+}
+
+// Finds visible faces of voxels inside @p box, see ChunkMesher::CullHidden()
+void CullBox(const VoxelType* voxels, unsigned char* visibleFaces, const ChunkApron* apron,
+             const VoxelBox& box)
+{
+    // Neighbours are found by offsetting the index, see VoxelIndex()
+    const size_t strideX = CHUNK_Y * CHUNK_Z;
+    const size_t strideY = CHUNK_Z;
+
+    for (int x = box.begin[0]; x < box.end[0]; ++x)
+        for (int y = box.begin[1]; y < box.end[1]; ++y)
+            for (int z = box.begin[2]; z < box.end[2]; ++z)
+            {
+                size_t i = VoxelIndex(x, y, z);
+                if (!IsSolid(voxels[i]))
+                {
+                    visibleFaces[i] = 0;
+                    continue;
+                }
+
+                // Face is hidden only by a solid neighbour. Neighbours beyond chunk's sides come
+                // from the apron, if there is none they are unknown and their faces are kept.
+                VoxelType xPlus = VoxelType::Unknown;
+                VoxelType xMinus = VoxelType::Unknown;
+                VoxelType zPlus = VoxelType::Unknown;
+                VoxelType zMinus = VoxelType::Unknown;
+                if (x < CHUNK_X - 1)
+                    xPlus = voxels[i + strideX];
+                else if (apron)
+                    xPlus = apron->xPlus[y * CHUNK_Z + z];
+                if (x > 0)
+                    xMinus = voxels[i - strideX];
+                else if (apron)
+                    xMinus = apron->xMinus[y * CHUNK_Z + z];
+                if (z < CHUNK_Z - 1)
+                    zPlus = voxels[i + 1];
+                else if (apron)
+                    zPlus = apron->zPlus[x * CHUNK_Y + y];
+                if (z > 0)
+                    zMinus = voxels[i - 1];
+                else if (apron)
+                    zMinus = apron->zMinus[x * CHUNK_Y + y];
+
+                unsigned char faces = 0;
+                if (!IsSolid(xPlus))
+                    faces |= ChunkMesher::FACE_X_PLUS;
+                if (!IsSolid(xMinus))
+                    faces |= ChunkMesher::FACE_X_MINUS;
+                if (y == CHUNK_Y - 1 || !IsSolid(voxels[i + strideY]))
+                    faces |= ChunkMesher::FACE_Y_PLUS;
+                if (y == 0 || !IsSolid(voxels[i - strideY]))
+                    faces |= ChunkMesher::FACE_Y_MINUS;
+                if (!IsSolid(zPlus))
+                    faces |= ChunkMesher::FACE_Z_PLUS;
+                if (!IsSolid(zMinus))
+                    faces |= ChunkMesher::FACE_Z_MINUS;
+
+                visibleFaces[i] = faces;
+            }
+}
+
+// Greedily merges a mask of cols x rows voxels (cell [col, row] stored at row * cols + col) into
+// rectangles of equal voxels. Each rectangle grows along columns first, then takes as many
+// following rows as it can, as long as they match along its whole width. Merged cells are
+// cleared to Air. Rectangles are passed to @p emit as (col, row, width, height, voxel).
+template <typename EmitFunc>
+void MergeMask(VoxelType* mask, int cols, int rows, EmitFunc emit)
+{
+    for (int row = 0; row < rows; ++row)
+    {
+        VoxelType* line = mask + row * cols;
+        for (int col = 0; col < cols; )
+        {
+            VoxelType vox = line[col];
+            if (!IsSolid(vox))
+            {
+                col++;
+                continue;
+            }
+
+            int w = 1;
+            while (col + w < cols && line[col + w] == vox)
+                w++;
+
+            int h = 1;
+            for (; row + h < rows; ++h)
+            {
+                const VoxelType* next = line + h * cols + col;
+                if (std::find_if(next, next + w, [vox](VoxelType v) { return v != vox; }) !=
+                    next + w)
+                    break;
+            }
+
+            emit(col, row, w, h, vox);
+
+            for (int i = 0; i < h; ++i)
+                std::fill(line + i * cols + col, line + i * cols + col + w, VoxelType::Air);
+            col += w;
+        }
+    }
+}
+
+} // namespace
+
+
+MeshingScratch::MeshingScratch()
+    : visibleFaces(CHUNK_VOXEL_COUNT)
+    , lodVoxels(CHUNK_VOXEL_COUNT)
+{
+}
+
+MeshingScratch& ChunkMesher::GetThreadScratch() noexcept
+{
+    static thread_local MeshingScratch scratch;
+    return scratch;
+}
+
+void ChunkMesher::GenerateQuadIndices(size_t quadCount, std::vector<unsigned int>& indices)
+{
+    // Quad's vertices 0, 1, 2, 3 make triangles (0, 1, 2) and (2, 1, 3)
+    indices.resize(quadCount * QUAD_INDEX_COUNT);
+    for (size_t i = 0; i < quadCount; ++i)
+    {
+        unsigned int first = static_cast<unsigned int>(i * QUAD_VERTEX_COUNT);
+        unsigned int* quadIndices = indices.data() + i * QUAD_INDEX_COUNT;
+        quadIndices[0] = first;
+        quadIndices[1] = first + 1;
+        quadIndices[2] = first + 2;
+        quadIndices[3] = first + 2;
+        quadIndices[4] = first + 1;
+        quadIndices[5] = first + 3;
+    }
+}
+
+void ChunkMesher::GenerateCube(std::vector<PackedVertex>& verts)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+    voxels[VoxelIndex(0, 0, 0)] = VoxelType::Stone;
+    std::vector<PackedVertex> quadVerts;
+    GenerateGreedy(voxels.data(), quadVerts);
+
+    std::vector<unsigned int> indices;
+    GenerateQuadIndices(quadVerts.size() / QUAD_VERTEX_COUNT, indices);
+    verts.clear();
+    for (unsigned int index : indices)
+    {
+        verts.push_back(quadVerts[index]);
+        verts.back().voxel = 0;
+    }
+}
+
+int ChunkMesher::CalculateMeshHeight(const VoxelType* voxels) noexcept
+{
+    // X slices are contiguous, so scan each slice backwards until the first solid voxel
+    const int sliceSize = CHUNK_Y * CHUNK_Z;
+    int height = 0;
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        const VoxelType* slice = voxels + x * sliceSize;
+        for (int i = sliceSize - 1; i >= height * CHUNK_Z; --i)
+            if (slice[i] != VoxelType::Air)
+            {
+                height = i / CHUNK_Z + 1;
+                break;
+            }
+    }
+
+    return height;
+}
+
+void ChunkMesher::GenerateNaive(const VoxelType* voxels, std::vector<float>& verts,
+                                const ChunkApron* apron)
+{
+    // Voxels with no visible faces are surrounded by other voxels. Ergo, they are not visible.
+    std::vector<unsigned char>& visibleFaces = GetThreadScratch().visibleFaces;
+    int height = CullHidden(voxels, visibleFaces.data(), apron);
+
+    // Count kept voxels first, so verts grow at most once and to the exact size
+    size_t keptCount = 0;
+    size_t layersEnd = static_cast<size_t>(height) * CHUNK_Z;
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        const unsigned char* slice = visibleFaces.data() + VoxelIndex(x, 0, 0);
+        for (size_t i = 0; i < layersEnd; ++i)
+            keptCount += (slice[i] != 0);
+    }
+
+    verts.clear();
+    verts.reserve(keptCount * FLOAT_COUNT_PER_VERTEX_NAIVE);
+    for (int z = 0; z < CHUNK_Z; ++z)
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < CHUNK_X; ++x)
+            {
+                size_t i = VoxelIndex(x, y, z);
+                if (visibleFaces[i] != 0)
+                {
+                    VoxelType vox = voxels[i];
+                    auto voxDataIt = VoxelDB.find(vox);
+                    if (voxDataIt == VoxelDB.end())
+                    {
+                        LOG_E("Voxel " << static_cast<VoxelUnderType>(vox)
+                              << " was not found in database!");
+                        continue;
+                    }
+
+                    verts.push_back(static_cast<float>(x));
+                    verts.push_back(static_cast<float>(y));
+                    verts.push_back(static_cast<float>(z));
+
+                    const Voxel& voxData = voxDataIt->second;
+                    verts.push_back(voxData.colorRed);
+                    verts.push_back(voxData.colorGreen);
+                    verts.push_back(voxData.colorBlue);
+                    verts.push_back(ALPHA_COMPONENT);
+                }
+            }
+}
+
+void ChunkMesher::GenerateInstanced(const VoxelType* voxels, std::vector<CubeInstance>& instances,
+                                    const ChunkApron* apron)
+{
+    std::vector<unsigned char>& visibleFaces = GetThreadScratch().visibleFaces;
+    int height = CullHidden(voxels, visibleFaces.data(), apron);
+
+    // Count kept voxels first, the same way as GenerateNaive() does
+    size_t keptCount = 0;
+    size_t layersEnd = static_cast<size_t>(height) * CHUNK_Z;
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        const unsigned char* slice = visibleFaces.data() + VoxelIndex(x, 0, 0);
+        for (size_t i = 0; i < layersEnd; ++i)
+            keptCount += (slice[i] != 0);
+    }
+
+    instances.clear();
+    instances.reserve(keptCount);
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        size_t sliceBegin = VoxelIndex(x, 0, 0);
+        for (size_t i = 0; i < layersEnd; ++i)
+        {
+            unsigned char faces = visibleFaces[sliceBegin + i];
+            if (faces == 0)
+                continue;
+
+            CubeInstance instance = {
+                static_cast<unsigned char>(x),
+                static_cast<unsigned char>(i / CHUNK_Z),
+                static_cast<unsigned char>(i % CHUNK_Z),
+                faces,
+                static_cast<unsigned char>(voxels[sliceBegin + i]),
+                { 0, 0, 0 }
+            };
+            instances.push_back(instance);
+        }
+    }
+}
+
+void ChunkMesher::ProcessPlaneX(const VoxelType* voxels, const unsigned char* visibleFaces,
+                                unsigned char face, int section, const Vector& shift,
+                                std::vector<quad>& resultQuads)
+{
+    // Slice of constant x - columns go along z, rows along y
+    VoxelBox box = GetSectionBox(section);
+    VoxelType mask[SECTION_SIZE * SECTION_SIZE];
+    for (int x = box.begin[0]; x < box.end[0]; ++x)
+    {
+        for (int y = box.begin[1]; y < box.end[1]; ++y)
+            for (int z = box.begin[2]; z < box.end[2]; ++z)
+            {
+                size_t i = VoxelIndex(x, y, z);
+                mask[(y - box.begin[1]) * SECTION_SIZE + (z - box.begin[2])] =
+                    (visibleFaces[i] & face) ? voxels[i] : VoxelType::Air;
+            }
+
+        MergeMask(mask, SECTION_SIZE, SECTION_SIZE, [&](int z, int y, int w, int h, VoxelType v)
+        {
+            resultQuads.push_back({Vector(static_cast<float>(x),
+                                          static_cast<float>(box.begin[1] + y),
+                                          static_cast<float>(box.begin[2] + z), 0.0f) + shift,
+                                   w, h, v});
+        });
+    }
+}
+
+void ChunkMesher::ProcessPlaneY(const VoxelType* voxels, const unsigned char* visibleFaces,
+                                unsigned char face, int section, const Vector& shift,
+                                std::vector<quad>& resultQuads)
+{
+    // Slice of constant y - columns go along x, rows along z
+    VoxelBox box = GetSectionBox(section);
+    VoxelType mask[SECTION_SIZE * SECTION_SIZE];
+    for (int y = box.begin[1]; y < box.end[1]; ++y)
+    {
+        for (int z = box.begin[2]; z < box.end[2]; ++z)
+            for (int x = box.begin[0]; x < box.end[0]; ++x)
+            {
+                size_t i = VoxelIndex(x, y, z);
+                mask[(z - box.begin[2]) * SECTION_SIZE + (x - box.begin[0])] =
+                    (visibleFaces[i] & face) ? voxels[i] : VoxelType::Air;
+            }
+
+        MergeMask(mask, SECTION_SIZE, SECTION_SIZE, [&](int x, int z, int w, int h, VoxelType v)
+        {
+            resultQuads.push_back({Vector(static_cast<float>(box.begin[0] + x),
+                                          static_cast<float>(y),
+                                          static_cast<float>(box.begin[2] + z), 0.0f) + shift,
+                                   w, h, v});
+        });
+    }
+}
+
+void ChunkMesher::ProcessPlaneZ(const VoxelType* voxels, const unsigned char* visibleFaces,
+                                unsigned char face, int section, const Vector& shift,
+                                std::vector<quad>& resultQuads)
+{
+    // Slice of constant z - columns go along x, rows along y
+    VoxelBox box = GetSectionBox(section);
+    VoxelType mask[SECTION_SIZE * SECTION_SIZE];
+    for (int z = box.begin[2]; z < box.end[2]; ++z)
+    {
+        for (int y = box.begin[1]; y < box.end[1]; ++y)
+            for (int x = box.begin[0]; x < box.end[0]; ++x)
+            {
+                size_t i = VoxelIndex(x, y, z);
+                mask[(y - box.begin[1]) * SECTION_SIZE + (x - box.begin[0])] =
+                    (visibleFaces[i] & face) ? voxels[i] : VoxelType::Air;
+            }
+
+        MergeMask(mask, SECTION_SIZE, SECTION_SIZE, [&](int x, int y, int w, int h, VoxelType v)
+        {
+            resultQuads.push_back({Vector(static_cast<float>(box.begin[0] + x),
+                                          static_cast<float>(box.begin[1] + y),
+                                          static_cast<float>(z), 0.0f) + shift,
+                                   w, h, v});
+        });
+    }
+}
+
+void ChunkMesher::PushVertsFromQuads(const std::vector<quad>& quads, const Vector& normal,
+                                     std::vector<PackedVertex>& verts)
+{
+    Vector v0, v1, v2, v3;
+    unsigned char normalIndex = GetNormalIndex(normal);
+
+    for (const auto& q : quads)
+    {
+        v0 = q.start;
+        // Shifting to match how Naive mesher expanded the verts to voxels.
+        if (normal[0] != 0.0f)
+        {
+            // Processing quads from X pass
+            v1 = q.start + Vector(0.0f, 0.0f, static_cast<float>(q.w), 0.0f);
+            v2 = q.start + Vector(0.0f, static_cast<float>(q.h), 0.0f, 0.0f);
+            v3 = q.start + Vector(0.0f, static_cast<float>(q.h), static_cast<float>(q.w), 0.0f);
+        }
+        else if (normal[1] != 0.0f)
+        {
+            // Processing quads from Y pass
+            v1 = q.start + Vector(static_cast<float>(q.w), 0.0f, 0.0f, 0.0f);
+            v2 = q.start + Vector(0.0f, 0.0f, static_cast<float>(q.h), 0.0f);
+            v3 = q.start + Vector(static_cast<float>(q.w), 0.0f, static_cast<float>(q.h), 0.0f);
+        }
+        else if (normal[2] != 0.0f)
+        {
+            // Processing quads from Z pass
+            v1 = q.start + Vector(static_cast<float>(q.w), 0.0f, 0.0f, 0.0f);
+            v2 = q.start + Vector(0.0f, static_cast<float>(q.h), 0.0f, 0.0f);
+            v3 = q.start + Vector(static_cast<float>(q.w), static_cast<float>(q.h), 0.0f, 0.0f);
+        }
+
+        auto pushVerts = [&verts, normalIndex](const Vector& v, VoxelType vox) {
+            // Quad corners lie halfway between voxel centers, see PackedVertex
+            PackedVertex vert = {
+                static_cast<unsigned char>(v[0] + 0.5f),
+                static_cast<unsigned char>(v[1] + 0.5f),
+                static_cast<unsigned char>(v[2] + 0.5f),
+                normalIndex, static_cast<VoxelUnderType>(vox), {0, 0, 0}
+            };
+            verts.push_back(vert);
+        };
+
+        pushVerts(v0, q.v); // first vert
+
+        // Decide which order to take according to normals (they will help us
+        // select which side of the cube are we processing to set the vert order aka. tri strip)
+        // For some weird reason, the order was correct for all passes except for X pass.
+        // Instead of figuring out what is wrong, it is much easier to just fix a condition.
+        // Triangles are made by GenerateQuadIndices() - second and third verts are shared.
+        if ((normal[0] == 1.0f) || (normal[1] == -1.0f) || (normal[2] == -1.0f))
+        {
+            pushVerts(v2, q.v); // third vert
+            pushVerts(v1, q.v); // second vert
+        }
+        else
+        {
+            pushVerts(v1, q.v); // second vert
+            pushVerts(v2, q.v); // third vert
+        }
+
+        pushVerts(v3, q.v); // fourth vert
+    }
+}
+
+void ChunkMesher::BuildApron(const VoxelType* xPlus, const VoxelType* xMinus,
+                             const VoxelType* zPlus, const VoxelType* zMinus,
+                             ChunkApron& apron) noexcept
+{
+    // X slices are contiguous, so they are copied as a whole
+    const size_t sliceSize = CHUNK_Y * CHUNK_Z;
+    if (xPlus)
+        std::copy(xPlus, xPlus + sliceSize, apron.xPlus);
+    else
+        std::fill(apron.xPlus, apron.xPlus + sliceSize, VoxelType::Unknown);
+
+    if (xMinus)
+        std::copy(xMinus + (CHUNK_X - 1) * sliceSize, xMinus + CHUNK_X * sliceSize, apron.xMinus);
+    else
+        std::fill(apron.xMinus, apron.xMinus + sliceSize, VoxelType::Unknown);
+
+    for (int x = 0; x < CHUNK_X; ++x)
+        for (int y = 0; y < CHUNK_Y; ++y)
+        {
+            apron.zPlus[x * CHUNK_Y + y] = zPlus ? zPlus[VoxelIndex(x, y, 0)]
+                                                 : VoxelType::Unknown;
+            apron.zMinus[x * CHUNK_Y + y] = zMinus ? zMinus[VoxelIndex(x, y, CHUNK_Z - 1)]
+                                                   : VoxelType::Unknown;
+        }
+}
+
+int ChunkMesher::CullHidden(const VoxelType* voxels, unsigned char* visibleFaces,
+                            const ChunkApron* apron) noexcept
+{
+    // Layers above mesh height are all air
+    std::fill(visibleFaces, visibleFaces + CHUNK_VOXEL_COUNT, 0);
+
+    int height = CalculateMeshHeight(voxels);
+    VoxelBox box = {{ 0, 0, 0 }, { CHUNK_X, height, CHUNK_Z }};
+    CullBox(voxels, visibleFaces, apron, box);
+    return height;
+}
+
+void ChunkMesher::Downsample(const VoxelType* voxels, unsigned int lod,
+                             VoxelType* result) noexcept
+{
+    const int size = 1 << lod;
+    const int half = size * size * size / 2;
+
+    for (int bx = 0; bx < CHUNK_X; bx += size)
+        for (int by = 0; by < CHUNK_Y; by += size)
+            for (int bz = 0; bz < CHUNK_Z; bz += size)
+            {
+                // Layers are scanned from the top, so the first solid voxel is the topmost one
+                int solid = 0;
+                VoxelType top = VoxelType::Air;
+                for (int y = by + size - 1; y >= by; --y)
+                    for (int x = bx; x < bx + size; ++x)
+                        for (int z = bz; z < bz + size; ++z)
+                        {
+                            VoxelType vox = voxels[VoxelIndex(x, y, z)];
+                            if (!IsSolid(vox))
+                                continue;
+
+                            if (solid++ == 0)
+                                top = vox;
+                        }
+
+                VoxelType block = (solid >= half) ? top : VoxelType::Air;
+                for (int x = bx; x < bx + size; ++x)
+                    for (int y = by; y < by + size; ++y)
+                    {
+                        VoxelType* row = result + VoxelIndex(x, y, bz);
+                        std::fill(row, row + size, block);
+                    }
+            }
+}
+
+size_t ChunkMesher::CountBorderFaces(const unsigned char* visibleFaces) noexcept
+{
+    size_t count = 0;
+    for (int y = 0; y < CHUNK_Y; ++y)
+    {
+        for (int z = 0; z < CHUNK_Z; ++z)
+        {
+            if (visibleFaces[VoxelIndex(CHUNK_X - 1, y, z)] & FACE_X_PLUS)
+                count++;
+            if (visibleFaces[VoxelIndex(0, y, z)] & FACE_X_MINUS)
+                count++;
+        }
+
+        for (int x = 0; x < CHUNK_X; ++x)
+        {
+            if (visibleFaces[VoxelIndex(x, y, CHUNK_Z - 1)] & FACE_Z_PLUS)
+                count++;
+            if (visibleFaces[VoxelIndex(x, y, 0)] & FACE_Z_MINUS)
+                count++;
+        }
+    }
+
+    return count;
+}
+
+void ChunkMesher::GenerateGreedy(const VoxelType* voxels, std::vector<PackedVertex>& verts,
+                                 const ChunkApron* apron, SectionRange* sections)
+{
+    // First stage of greedy meshing - find which faces of which voxels can be seen at all
+    const unsigned char* visibleFaces = GetThreadScratch().visibleFaces.data();
+    int height = CullHidden(voxels, GetThreadScratch().visibleFaces.data(), apron);
+
+    // Sections follow each other in the order of their indices. Sections lying entirely above
+    // mesh height have no faces.
+    verts.clear();
+    for (int section = 0; section < SECTION_COUNT; ++section)
+    {
+        size_t first = verts.size();
+        if (GetSectionBox(section).begin[1] < height)
+            GenerateSectionVerts(voxels, visibleFaces, section, verts);
+
+        if (sections)
+            sections[section] = { first, verts.size() - first };
+    }
+}
+
+void ChunkMesher::GenerateGreedySection(const VoxelType* voxels, int section,
+                                        std::vector<PackedVertex>& verts, const ChunkApron* apron)
+{
+    // Faces of the section depend only on its own voxels and their direct neighbours
+    unsigned char* visibleFaces = GetThreadScratch().visibleFaces.data();
+    CullBox(voxels, visibleFaces, apron, GetSectionBox(section));
+
+    verts.clear();
+    GenerateSectionVerts(voxels, visibleFaces, section, verts);
+}
+
+int ChunkMesher::GetSectionIndex(int x, int y, int z) noexcept
+{
+    return ((x / SECTION_SIZE) * SECTION_COUNT_Y + y / SECTION_SIZE) * SECTION_COUNT_Z +
+           z / SECTION_SIZE;
+}
+
+void ChunkMesher::GenerateSectionVerts(const VoxelType* voxels, const unsigned char* visibleFaces,
+                                       int section, std::vector<PackedVertex>& verts)
+{
+    MeshingScratch& scratch = GetThreadScratch();
+
+    // Now we have to do six passes, two per each axis. Quads of previous section are dropped,
+    // but their memory stays for this one.
+    for (std::vector<quad>& quads : scratch.quads)
+        quads.clear();
+
+    std::vector<quad>& quadsXPlus = scratch.quads[0];
+    std::vector<quad>& quadsXMinus = scratch.quads[1];
+    std::vector<quad>& quadsYPlus = scratch.quads[2];
+    std::vector<quad>& quadsYMinus = scratch.quads[3];
+    std::vector<quad>& quadsZPlus = scratch.quads[4];
+    std::vector<quad>& quadsZMinus = scratch.quads[5];
+
+    // All shifts are by +/- 0.5f to match the behavior of Naive generator. Normals of Y quads
+    // point inside the voxel, so quadsYPlus are made of bottom faces and quadsYMinus of top ones.
+    ProcessPlaneX(voxels, visibleFaces, FACE_X_PLUS, section,
+                  Vector( 0.5f,-0.5f,-0.5f, 0.0f), quadsXPlus);
+    ProcessPlaneX(voxels, visibleFaces, FACE_X_MINUS, section,
+                  Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsXMinus);
+    ProcessPlaneY(voxels, visibleFaces, FACE_Y_MINUS, section,
+                  Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsYPlus);
+    ProcessPlaneY(voxels, visibleFaces, FACE_Y_PLUS, section,
+                  Vector(-0.5f, 0.5f,-0.5f, 0.0f), quadsYMinus);
+    ProcessPlaneZ(voxels, visibleFaces, FACE_Z_PLUS, section,
+                  Vector(-0.5f,-0.5f, 0.5f, 0.0f), quadsZPlus);
+    ProcessPlaneZ(voxels, visibleFaces, FACE_Z_MINUS, section,
+                  Vector(-0.5f,-0.5f,-0.5f, 0.0f), quadsZMinus);
+
+    // Push the quads after vertices of previous sections. Verts grow at most once per section,
+    // still at least doubling, so meshing whole chunk does not reallocate for every section.
+    size_t quadCount = 0;
+    for (const std::vector<quad>& quads : scratch.quads)
+        quadCount += quads.size();
+
+    size_t vertCount = verts.size() + quadCount * QUAD_VERTEX_COUNT;
+    if (vertCount > verts.capacity())
+        verts.reserve(std::max(vertCount, 2 * verts.capacity()));
+    PushVertsFromQuads(quadsXPlus,  Vector( 1.0f, 0.0f, 0.0f, 0.0f), verts);
+    PushVertsFromQuads(quadsXMinus, Vector(-1.0f, 0.0f, 0.0f, 0.0f), verts);
+    PushVertsFromQuads(quadsYPlus,  Vector( 0.0f, 1.0f, 0.0f, 0.0f), verts);
+    PushVertsFromQuads(quadsYMinus, Vector( 0.0f,-1.0f, 0.0f, 0.0f), verts);
+    PushVertsFromQuads(quadsZPlus,  Vector( 0.0f, 0.0f, 1.0f, 0.0f), verts);
+    PushVertsFromQuads(quadsZMinus, Vector( 0.0f, 0.0f,-1.0f, 0.0f), verts);
+}
@@ -0,0 +1,350 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Mesher declaration.
+ */
+
+#ifndef __TERRAIN_CHUNKMESHER_HPP__
+#define __TERRAIN_CHUNKMESHER_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+#include "Math/Vector.hpp"
+
+#include <vector>
+
+struct quad
+{
+    Vector start; // starting points
+    int w, h; // width and height
+    VoxelType v; // type of voxel to which the quad belongs
+};
+
+/**
+ * Vertex of greedy Mesh, packed into 8 bytes.
+ *
+ * Position is an integer voxel corner - voxel [x, y, z] spans corners from [x, y, z] to
+ * [x + 1, y + 1, z + 1]. Color and normal are looked up by MainVS.glsl using the palette and
+ * normal indices.
+ */
+struct PackedVertex
+{
+    unsigned char x, y, z;      ///< Chunk-local corner position.
+    unsigned char normal;       ///< Normal index, 0 - 5 for +X, -X, +Y, -Y, +Z, -Z.
+    unsigned char voxel;        ///< Palette index, VoxelType of the face.
+    unsigned char reserved[3];  ///< Keeps vertices 4-byte aligned, always 0.
+};
+
+/**
+ * Single voxel drawn by instanced Mesh, packed into 8 bytes.
+ *
+ * Every instance is drawn as the cube made by ChunkMesher::GenerateCube(), placed at the voxel's
+ * position. TerrainCubeVS.glsl collapses faces, which are hidden or face away from the camera.
+ */
+struct CubeInstance
+{
+    unsigned char x, y, z;      ///< Chunk-local voxel position.
+    unsigned char faces;        ///< Visible faces, ChunkMesher::FACE_* bit set.
+    unsigned char voxel;        ///< Palette index, VoxelType of the voxel.
+    unsigned char reserved[3];  ///< Keeps instances 4-byte aligned, always 0.
+};
+
+/**
+ * Voxels bordering a chunk from its four horizontal neighbours - a one voxel thick apron, which
+ * lets the mesher hide faces between chunks. Voxels of missing neighbours are VoxelType::Unknown,
+ * so faces facing them stay visible.
+ */
+struct ChunkApron
+{
+    VoxelType xPlus[CHUNK_Y * CHUNK_Z];     ///< Slice x = 0 of chunk [X + 1, Z], [y][z].
+    VoxelType xMinus[CHUNK_Y * CHUNK_Z];    ///< Slice x = CHUNK_X - 1 of chunk [X - 1, Z], [y][z].
+    VoxelType zPlus[CHUNK_X * CHUNK_Y];     ///< Slice z = 0 of chunk [X, Z + 1], [x][y].
+    VoxelType zMinus[CHUNK_X * CHUNK_Y];    ///< Slice z = CHUNK_Z - 1 of chunk [X, Z - 1], [x][y].
+};
+
+/**
+ * Vertices of a single section in a greedy Mesh, see ChunkMesher::SECTION_SIZE.
+ */
+struct SectionRange
+{
+    size_t first;   ///< Index of section's first vertex.
+    size_t count;   ///< Amount of section's vertices, QUAD_VERTEX_COUNT per quad.
+};
+
+/**
+ * Working memory of ChunkMesher, kept by every thread between chunks. Vectors are only cleared
+ * before use, so once they grow to fit the largest chunk met so far, meshing does not touch the
+ * heap at all.
+ */
+struct MeshingScratch
+{
+    std::vector<unsigned char> visibleFaces;    ///< Faces found by CullHidden().
+    std::vector<quad> quads[6];                 ///< Merged quads of six greedy passes.
+    ChunkApron apron;                           ///< Apron of the chunk being meshed.
+    std::vector<PackedVertex> verts;            ///< Vertices staged before caller copies them.
+    std::vector<VoxelType> lodVoxels;           ///< Voxels coarsened by Downsample().
+
+    MeshingScratch();
+};
+
+/**
+ * Converts Chunk's voxels to vertices of its Mesh.
+ *
+ * Mesher works only on raw voxel data and produces plain float arrays, so it can be used without
+ * an OpenGL context (ex. in benchmarks and tests). Uploading vertices is up to Chunk.
+ */
+class ChunkMesher
+{
+public:
+    /**
+     * Amount of floats per vertex produced by GenerateNaive() - pos.xyz, col.rgba.
+     */
+    static const int FLOAT_COUNT_PER_VERTEX_NAIVE = 7;
+
+    /**
+     * Amount of vertices per quad produced by GenerateGreedy().
+     */
+    static const int QUAD_VERTEX_COUNT = 4;
+
+    /**
+     * Amount of indices per quad in buffer made by GenerateQuadIndices() - two triangles.
+     */
+    static const int QUAD_INDEX_COUNT = 6;
+
+    /**
+     * Amount of vertices of the cube made by GenerateCube() - six quads, split into triangles.
+     */
+    static const int CUBE_VERTEX_COUNT = 6 * QUAD_INDEX_COUNT;
+
+    /**
+     * Greedy meshes are made of cubic sections, SECTION_SIZE voxels long. Faces are merged only
+     * within a section, so a single section can be meshed again after its voxels change.
+     */
+    static const int SECTION_SIZE = 16;
+    static const int SECTION_COUNT_X = CHUNK_X / SECTION_SIZE;
+    static const int SECTION_COUNT_Y = CHUNK_Y / SECTION_SIZE;
+    static const int SECTION_COUNT_Z = CHUNK_Z / SECTION_SIZE;
+    static const int SECTION_COUNT = SECTION_COUNT_X * SECTION_COUNT_Y * SECTION_COUNT_Z;
+
+    /**
+     * Amount of levels of detail. Level N is meshed from voxels coarsened into blocks of
+     * 2^N x 2^N x 2^N voxels, see Downsample(). Level 0 is the full resolution.
+     */
+    static const unsigned int LOD_LEVEL_COUNT = 3;
+
+    /**
+     * Bits of voxel's visible faces, as computed by CullHidden(). Face FACE_X_PLUS lies at
+     * x + 0.5 and borders voxel [x + 1, y, z], and so on.
+     */
+    static const unsigned char FACE_X_PLUS = 0x01;
+    static const unsigned char FACE_X_MINUS = 0x02;
+    static const unsigned char FACE_Y_PLUS = 0x04;
+    static const unsigned char FACE_Y_MINUS = 0x08;
+    static const unsigned char FACE_Z_PLUS = 0x10;
+    static const unsigned char FACE_Z_MINUS = 0x20;
+
+    /**
+     * Generates vertices from @p voxels using naive method.
+     *
+     * @param voxels Array of CHUNK_VOXEL_COUNT voxels.
+     * @param verts  Output vertices. Previous contents are discarded.
+     * @param apron  Voxels of neighbouring chunks. If nullptr, voxels on chunk's boundaries are
+     *               always kept.
+     *
+     * Created Mesh will contain a cloud of points, which shall be evolved into triangles
+     * by Geometry Shader. Only voxels with at least one visible face are kept. Working memory
+     * comes from GetThreadScratch() and @p verts keeps its capacity, so remeshing allocates only
+     * when a chunk needs more memory than any chunk meshed before.
+     *
+     * The Naive generator is faster and more reliable, but enforces more workload on GPU. Thus,
+     * it is mostly used for debugging purposes. Release code should contain Chunk Mesh
+     * generated using GenerateGreedy().
+     */
+    static void GenerateNaive(const VoxelType* voxels, std::vector<float>& verts,
+                              const ChunkApron* apron = nullptr);
+
+    /**
+     * Generates cube instances from @p voxels, drawn with a single static cube Mesh.
+     *
+     * @param voxels    Array of CHUNK_VOXEL_COUNT voxels.
+     * @param instances Output instances, one per voxel with at least one visible face. Previous
+     *                  contents are discarded.
+     * @param apron     Voxels of neighbouring chunks, as passed to GenerateNaive().
+     *
+     * Keeps the same voxels as GenerateNaive(), but without a Geometry Shader - every instance
+     * takes only 8 bytes and carries its visible faces, so hidden faces are skipped as well.
+     * Memory is reused the same way as by GenerateNaive().
+     */
+    static void GenerateInstanced(const VoxelType* voxels, std::vector<CubeInstance>& instances,
+                                  const ChunkApron* apron = nullptr);
+
+    /**
+     * Generates vertices from @p voxels using Greedy Meshing algorithm.
+     *
+     * @param voxels Array of CHUNK_VOXEL_COUNT voxels.
+     * @param verts  Output vertices, QUAD_VERTEX_COUNT per quad. Previous contents are discarded.
+     * @param apron    Voxels of neighbouring chunks. If nullptr, faces on chunk's boundaries
+     *                 are always visible.
+     * @param sections Optional output array of SECTION_COUNT ranges, telling where vertices of
+     *                 each section lie in @p verts. Sections are stored in order of their indices.
+     *
+     * Created Mesh will contain a list of quads, drawn as triangles with indices made by
+     * GenerateQuadIndices(). No Geometry Shader work is needed to render the Chunk, giving us
+     * more GPU workload for graphical effects. Memory is reused the same way as by
+     * GenerateNaive().
+     */
+    static void GenerateGreedy(const VoxelType* voxels, std::vector<PackedVertex>& verts,
+                               const ChunkApron* apron = nullptr,
+                               SectionRange* sections = nullptr);
+
+    /**
+     * Generates vertices of a single section of @p voxels, the same as GenerateGreedy() would
+     * place in section's range.
+     *
+     * @param voxels  Array of CHUNK_VOXEL_COUNT voxels.
+     * @param section Index of the section, see GetSectionIndex().
+     * @param verts   Output vertices. Previous contents are discarded.
+     * @param apron   Voxels of neighbouring chunks, as passed to GenerateGreedy().
+     */
+    static void GenerateGreedySection(const VoxelType* voxels, int section,
+                                      std::vector<PackedVertex>& verts,
+                                      const ChunkApron* apron = nullptr);
+
+    /**
+     * Calculates index of the section containing voxel [@p x, @p y, @p z]. Sections are ordered
+     * the same way as voxels - index = x * SECTION_COUNT_Y * SECTION_COUNT_Z + y *
+     * SECTION_COUNT_Z + z, in section units.
+     */
+    static int GetSectionIndex(int x, int y, int z) noexcept;
+
+    /**
+     * Generates indices splitting quads made by GenerateGreedy() into triangles. The indices do
+     * not depend on the mesh, so a single index buffer can be shared by all greedy meshes with
+     * up to @p quadCount quads.
+     *
+     * @param quadCount Amount of quads.
+     * @param indices   Output indices, QUAD_INDEX_COUNT per quad. Previous contents are discarded.
+     */
+    static void GenerateQuadIndices(size_t quadCount, std::vector<unsigned int>& indices);
+
+    /**
+     * Generates the cube drawn for every instance made by GenerateInstanced().
+     *
+     * @param verts Output vertices, CUBE_VERTEX_COUNT of them, forming triangles. Previous
+     *              contents are discarded.
+     *
+     * The cube is a greedy Mesh of voxel [0, 0, 0], so its corners, normals and winding match
+     * greedy meshes exactly. Palette indices are left 0, voxel type comes from the instance.
+     */
+    static void GenerateCube(std::vector<PackedVertex>& verts);
+
+    /**
+     * Calculates amount of bottom layers of @p voxels, which contain any solid voxels. Layers
+     * above are skipped by meshers.
+     */
+    static int CalculateMeshHeight(const VoxelType* voxels) noexcept;
+
+    /**
+     * Copies voxels bordering a chunk from its neighbours to @p apron.
+     *
+     * @param xPlus  Voxels of chunk [X + 1, Z], or nullptr if it is not available.
+     * @param xMinus Voxels of chunk [X - 1, Z], or nullptr if it is not available.
+     * @param zPlus  Voxels of chunk [X, Z + 1], or nullptr if it is not available.
+     * @param zMinus Voxels of chunk [X, Z - 1], or nullptr if it is not available.
+     * @param apron  Output apron.
+     */
+    static void BuildApron(const VoxelType* xPlus, const VoxelType* xMinus,
+                           const VoxelType* zPlus, const VoxelType* zMinus,
+                           ChunkApron& apron) noexcept;
+
+    /**
+     * Finds visible faces of @p voxels. A face is visible when the voxel it borders is not solid.
+     * First stage of both meshers.
+     *
+     * @param voxels       Array of CHUNK_VOXEL_COUNT voxels.
+     * @param visibleFaces Output array of CHUNK_VOXEL_COUNT FACE_* bit sets. Air voxels and
+     *                     voxels surrounded from all six sides get no bits.
+     * @param apron        Voxels of neighbouring chunks. If nullptr, faces on chunk's side
+     *                     boundaries are always visible. Top and bottom faces of the chunk are
+     *                     visible either way.
+     * @return Mesh height of @p voxels, as returned by CalculateMeshHeight().
+     */
+    static int CullHidden(const VoxelType* voxels, unsigned char* visibleFaces,
+                          const ChunkApron* apron = nullptr) noexcept;
+
+    /**
+     * Counts visible faces lying on chunk's four side boundaries.
+     *
+     * @param visibleFaces Array of CHUNK_VOXEL_COUNT FACE_* bit sets, as found by CullHidden().
+     *
+     * Comparing counts found with and without an apron tells how many faces between chunks
+     * the apron has hidden.
+     */
+    static size_t CountBorderFaces(const unsigned char* visibleFaces) noexcept;
+
+    /**
+     * Coarsens @p voxels for a distant, lower detail Mesh. Voxels are split into cubic blocks,
+     * 2^@p lod voxels long, and every block is filled with a single voxel. Block is solid when at
+     * least half of its voxels are solid, and takes type of its topmost solid voxel, so surface
+     * keeps its look from above (ex. grass stays on top).
+     *
+     * @param voxels Array of CHUNK_VOXEL_COUNT voxels.
+     * @param lod    Level of detail, below LOD_LEVEL_COUNT. Level 0 copies voxels unchanged.
+     * @param result Output array of CHUNK_VOXEL_COUNT voxels, in the same layout.
+     *
+     * Result is meshed as usual. Blocks merge into larger quads, and faces within a block are
+     * never emitted, so the Mesh has far fewer quads.
+     */
+    static void Downsample(const VoxelType* voxels, unsigned int lod, VoxelType* result) noexcept;
+
+    /**
+     * Acquire MeshingScratch of calling thread, used by GenerateNaive() and GenerateGreedy().
+     * Apron can be built in it before meshing, sparing a copy on the stack.
+     *
+     * @remarks Scratch lives as long as the thread. Memory is not shared between threads, so no
+     * locking is needed.
+     */
+    static MeshingScratch& GetThreadScratch() noexcept;
+
+private:
+    /**
+     * Processes @p section from X plane perspective. Only faces having @p face bit set in
+     * @p visibleFaces are taken. Faces in every slice are merged along z and y into as large
+     * rectangles of the same voxel type as possible.
+     */
+    static void ProcessPlaneX(const VoxelType* voxels, const unsigned char* visibleFaces,
+                              unsigned char face, int section, const Vector& shift,
+                              std::vector<quad>& resultQuads);
+
+    /**
+     * Processes @p section from Y plane perspective. Only faces having @p face bit set in
+     * @p visibleFaces are taken. Faces in every slice are merged along x and z into as large
+     * rectangles of the same voxel type as possible.
+     */
+    static void ProcessPlaneY(const VoxelType* voxels, const unsigned char* visibleFaces,
+                              unsigned char face, int section, const Vector& shift,
+                              std::vector<quad>& resultQuads);
+
+    /**
+     * Processes @p section from Z plane perspective. Only faces having @p face bit set in
+     * @p visibleFaces are taken. Faces in every slice are merged along x and y into as large
+     * rectangles of the same voxel type as possible.
+     */
+    static void ProcessPlaneZ(const VoxelType* voxels, const unsigned char* visibleFaces,
+                              unsigned char face, int section, const Vector& shift,
+                              std::vector<quad>& resultQuads);
+
+    /**
+     * Merges visible faces of @p section into quads and appends their vertices to @p verts.
+     */
+    static void GenerateSectionVerts(const VoxelType* voxels, const unsigned char* visibleFaces,
+                                     int section, std::vector<PackedVertex>& verts);
+
+    /**
+     * Pushes generated quads to @p verts array
+     */
+    static void PushVertsFromQuads(const std::vector<quad>& quads, const Vector& normal,
+                                   std::vector<PackedVertex>& verts);
+};
+
+#endif // __TERRAIN_CHUNKMESHER_HPP__
@@ -8,13 +8,20 @@
 
 
 ChunkPool::ChunkPool()
+    : mCompression(ChunkCompression::RLE)
 {
 }
 
 ChunkPool::~ChunkPool()
 {
     for (auto& chunk : mChunks)
-        chunk.second.SaveToDisk();
+        chunk.second.SaveToDisk(mCompression);
+}
+
+void ChunkPool::Init(ChunkCompression compression)
+{
+    mCompression = compression;
+    mManifest.Build(CHUNK_DIR);
 }
 
 Chunk* ChunkPool::GetChunk(int x, int z)
@@ -31,3 +38,27 @@ Chunk* ChunkPool::GetChunk(int x, int z)
 
     return &chunkIt->second;
 }
+
+Chunk* ChunkPool::FindChunk(int x, int z) noexcept
+{
+    auto chunkIt = mChunks.find(ChunkKeyType(x, z));
+    if (chunkIt == mChunks.end())
+        return nullptr;
+
+    return &chunkIt->second;
+}
+
+ChunkNeighbours ChunkPool::GetNeighbours(int x, int z) noexcept
+{
+    ChunkNeighbours neighbours;
+    neighbours.xPlus = FindChunk(x + 1, z);
+    neighbours.xMinus = FindChunk(x - 1, z);
+    neighbours.zPlus = FindChunk(x, z + 1);
+    neighbours.zMinus = FindChunk(x, z - 1);
+    return neighbours;
+}
+
+const ChunkManifest& ChunkPool::GetManifest() const noexcept
+{
+    return mManifest;
+}
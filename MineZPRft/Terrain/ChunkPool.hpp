@@ -8,6 +8,7 @@
 #define __TERRAIN_CHUNKPOOL_HPP__
 
 #include "Chunk.hpp"
+#include "ChunkManifest.hpp"
 
 #include <map>
 #include <tuple>
@@ -54,6 +55,15 @@ public:
     ChunkPool();
     ~ChunkPool();
 
+    /**
+     * Prepares the pool for work by building a manifest of chunks already saved on disk.
+     *
+     * @param compression Compression method used when saving chunks to disk.
+     *
+     * @remarks Must be called after current working directory is set up.
+     */
+    void Init(ChunkCompression compression);
+
     /**
      * Acquires a chunk which resides in [X, Z] position in the world.
      *
@@ -65,12 +75,34 @@ public:
      * way the pointer will be invalid.
      *
      * If the Chunk object was just constructed, it is returned in an initialized state. It is
-     * caller's duty to invoke Chunk::Generate() on this object to fill it with valid Voxel data.
+     * caller's duty to invoke Chunk::GenerateTerrain() on this object to fill it with valid Voxel data.
      */
     Chunk* GetChunk(int x, int z);
 
+    /**
+     * Finds a chunk which resides in [X, Z] position in the world, without constructing it.
+     *
+     * @return Pointer to managed Chunk object, or nullptr if it is not in the pool.
+     */
+    Chunk* FindChunk(int x, int z) noexcept;
+
+    /**
+     * Finds four chunks bordering the chunk at [X, Z] position in the world.
+     *
+     * @remarks Pool is not synchronized, so like GetChunk() it must be called by the thread which
+     * adds chunks to the pool. Returned pointers can be passed to other threads.
+     */
+    ChunkNeighbours GetNeighbours(int x, int z) noexcept;
+
+    /**
+     * Acquire manifest of chunks saved on disk.
+     */
+    const ChunkManifest& GetManifest() const noexcept;
+
 private:
     ChunkMapType mChunks;
+    ChunkManifest mManifest;
+    ChunkCompression mCompression;
 };
 
 #endif // __TERRAIN_CHUNKPOOL_HPP__
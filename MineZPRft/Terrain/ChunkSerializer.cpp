@@ -0,0 +1,221 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Serializer definitions.
+ */
+
+#include "ChunkSerializer.hpp"
+#include "VoxelFill.hpp"
+
+#include "Common/Compression.hpp"
+#include "Common/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+
+const unsigned char CHUNK_MAGIC[] = {'M', 'Z', 'C', 'H'};
+const unsigned char CHUNK_FORMAT_VERSION = 1;
+
+// magic, version, compression, RLE stream size (32-bit little endian)
+const size_t HEADER_SIZE = sizeof(CHUNK_MAGIC) + 2 + 4;
+
+// Column-major voxel order - Y is the fastest changing coordinate
+inline size_t ColumnMajorIndex(size_t column, size_t y)
+{
+    size_t x = column / CHUNK_Z;
+    size_t z = column % CHUNK_Z;
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+void WriteVarInt(uint32_t value, std::vector<unsigned char>& data)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<unsigned char>(value));
+}
+
+bool ReadVarInt(const unsigned char*& ptr, const unsigned char* end, uint32_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 32; shift += 7)
+    {
+        if (ptr == end)
+            return false;
+
+        unsigned char byte = *ptr++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+
+void ChunkSerializer::Serialize(const VoxelType* voxels, ChunkCompression compression,
+                                std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> rle;
+    EncodeRLE(voxels, rle);
+
+    data.clear();
+    data.reserve(HEADER_SIZE + rle.size());
+    for (unsigned char byte : CHUNK_MAGIC)
+        data.push_back(byte);
+    data.push_back(CHUNK_FORMAT_VERSION);
+    data.push_back(static_cast<unsigned char>(compression));
+
+    uint32_t rleSize = static_cast<uint32_t>(rle.size());
+    for (int i = 0; i < 4; ++i)
+        data.push_back(static_cast<unsigned char>(rleSize >> (8 * i)));
+
+    switch (compression)
+    {
+    case ChunkCompression::LZ:
+        Compression::LZCompress(rle.data(), rle.size(), data);
+        break;
+    case ChunkCompression::RLE:
+    default:
+        data.insert(data.end(), rle.begin(), rle.end());
+        break;
+    }
+}
+
+bool ChunkSerializer::Deserialize(const std::vector<unsigned char>& data, VoxelType* voxels)
+{
+    if (data.size() < HEADER_SIZE || memcmp(data.data(), CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) != 0)
+        return DecodeLegacy(data, voxels);
+
+    const unsigned char* header = data.data() + sizeof(CHUNK_MAGIC);
+    if (header[0] != CHUNK_FORMAT_VERSION)
+    {
+        LOG_E("Unsupported chunk format version " << static_cast<int>(header[0]));
+        return false;
+    }
+
+    ChunkCompression compression = static_cast<ChunkCompression>(header[1]);
+    uint32_t rleSize = 0;
+    for (int i = 0; i < 4; ++i)
+        rleSize |= static_cast<uint32_t>(header[2 + i]) << (8 * i);
+
+    const unsigned char* payload = data.data() + HEADER_SIZE;
+    size_t payloadSize = data.size() - HEADER_SIZE;
+
+    switch (compression)
+    {
+    case ChunkCompression::RLE:
+        if (payloadSize != rleSize)
+            return false;
+        return DecodeRLE(payload, payloadSize, voxels);
+
+    case ChunkCompression::LZ:
+    {
+        std::vector<unsigned char> rle(rleSize);
+        if (!Compression::LZDecompress(payload, payloadSize, rle.data(), rle.size()))
+            return false;
+        return DecodeRLE(rle.data(), rle.size(), voxels);
+    }
+
+    default:
+        LOG_E("Unknown chunk compression method " << static_cast<int>(header[1]));
+        return false;
+    }
+}
+
+void ChunkSerializer::EncodeRLE(const VoxelType* voxels, std::vector<unsigned char>& rle)
+{
+    // Runs continue over column boundaries, which matters for fully air or stone areas
+    VoxelType runVoxel = voxels[ColumnMajorIndex(0, 0)];
+    uint32_t runLength = 0;
+
+    for (size_t column = 0; column < CHUNK_X * CHUNK_Z; ++column)
+        for (size_t y = 0; y < CHUNK_Y; ++y)
+        {
+            VoxelType vox = voxels[ColumnMajorIndex(column, y)];
+            if (vox == runVoxel)
+            {
+                runLength++;
+                continue;
+            }
+
+            rle.push_back(static_cast<VoxelUnderType>(runVoxel));
+            WriteVarInt(runLength, rle);
+            runVoxel = vox;
+            runLength = 1;
+        }
+
+    rle.push_back(static_cast<VoxelUnderType>(runVoxel));
+    WriteVarInt(runLength, rle);
+}
+
+bool ChunkSerializer::DecodeRLE(const unsigned char* rle, size_t rleSize, VoxelType* voxels)
+{
+    const unsigned char* end = rle + rleSize;
+    size_t column = 0;
+    size_t y = 0;
+
+    while (rle < end)
+    {
+        VoxelUnderType vox = *rle++;
+        uint32_t runLength;
+        if (vox > static_cast<VoxelUnderType>(VoxelType::Unknown) || !ReadVarInt(rle, end, runLength))
+            return false;
+
+        if (runLength > CHUNK_VOXEL_COUNT - (column * CHUNK_Y + y))
+            return false;
+
+        // Split the run into column spans
+        while (runLength > 0)
+        {
+            size_t span = std::min<size_t>(runLength, CHUNK_Y - y);
+            int x = static_cast<int>(column / CHUNK_Z);
+            int z = static_cast<int>(column % CHUNK_Z);
+            FillColumn(voxels, x, z, static_cast<int>(y), static_cast<int>(y + span),
+                       static_cast<VoxelType>(vox));
+
+            runLength -= static_cast<uint32_t>(span);
+            y += span;
+            if (y == CHUNK_Y)
+            {
+                y = 0;
+                column++;
+            }
+        }
+    }
+
+    return column == CHUNK_X * CHUNK_Z;
+}
+
+bool ChunkSerializer::DecodeLegacy(const std::vector<unsigned char>& data, VoxelType* voxels)
+{
+    // Legacy format - decimal run length immediately followed by voxel byte, in storage order
+    std::istringstream stream(std::string(data.begin(), data.end()));
+
+    VoxelUnderType tempVox;
+    uint32_t counter;
+    for (int i = 0; i < CHUNK_VOXEL_COUNT; )
+    {
+        stream >> counter;
+        stream >> tempVox;
+
+        if (!stream)
+            return false;
+
+        do
+        {
+            counter--;
+            voxels[i++] = static_cast<VoxelType>(tempVox);
+        } while (counter && i < CHUNK_VOXEL_COUNT);
+    }
+
+    return true;
+}
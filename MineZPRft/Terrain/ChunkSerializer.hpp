@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Serializer declaration.
+ */
+
+#ifndef __TERRAIN_CHUNKSERIALIZER_HPP__
+#define __TERRAIN_CHUNKSERIALIZER_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+
+#include <vector>
+
+/**
+ * Compression applied to serialized chunk data, on top of run-length encoding.
+ */
+enum class ChunkCompression: unsigned char
+{
+    RLE = 0,    ///< Run-length encoding only.
+    LZ,         ///< Run-length encoding compressed further with Compression::LZCompress().
+};
+
+/**
+ * Converts Chunk's voxel arrays to a compact binary form, and back.
+ *
+ * Serialized chunk consists of a small header followed by a payload. Voxels are run-length
+ * encoded in column-major order (Y axis first), so a typical column of terrain collapses into just
+ * a few runs (bedrock, stone, air). Optionally, the RLE stream is further compressed, which catches
+ * repeating patterns between neighbouring columns.
+ *
+ * Compression method is recorded in the header, so any serialized chunk can be read back no
+ * matter which method was selected for the world at the time of saving.
+ */
+class ChunkSerializer
+{
+public:
+    /**
+     * Serialize @p voxels.
+     *
+     * @param voxels      Array of CHUNK_VOXEL_COUNT voxels.
+     * @param compression Compression method to apply.
+     * @param data        Output buffer. Its previous contents are discarded.
+     */
+    static void Serialize(const VoxelType* voxels, ChunkCompression compression,
+                          std::vector<unsigned char>& data);
+
+    /**
+     * Restore voxels from data created by Serialize().
+     *
+     * @param data   Serialized chunk.
+     * @param voxels Output array of CHUNK_VOXEL_COUNT voxels.
+     * @return True on success, false if @p data is corrupted.
+     *
+     * Data saved in legacy text RLE format (used before binary format was introduced) is detected
+     * and decoded as well.
+     */
+    static bool Deserialize(const std::vector<unsigned char>& data, VoxelType* voxels);
+
+private:
+    static void EncodeRLE(const VoxelType* voxels, std::vector<unsigned char>& rle);
+    static bool DecodeRLE(const unsigned char* rle, size_t rleSize, VoxelType* voxels);
+    static bool DecodeLegacy(const std::vector<unsigned char>& data, VoxelType* voxels);
+};
+
+#endif // __TERRAIN_CHUNKSERIALIZER_HPP__
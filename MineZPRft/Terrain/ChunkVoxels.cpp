@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Voxels definitions.
+ */
+
+#include "ChunkVoxels.hpp"
+
+#include "Common/Logger.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+
+ChunkVoxels::ChunkVoxels()
+{
+    for (VoxelType& voxel : mVoxels)
+        voxel = VoxelType::Air;
+}
+
+void ChunkVoxels::SetVoxel(size_t x, size_t y, size_t z, VoxelType voxel) noexcept
+{
+    size_t index = 0;
+    if (!CalculateIndex(x, y, z, index))
+        return;
+
+    mVoxels[index] = voxel;
+}
+
+VoxelType ChunkVoxels::GetVoxel(size_t x, size_t y, size_t z) const noexcept
+{
+    size_t index = 0;
+    if (!CalculateIndex(x, y, z, index))
+        return VoxelType::Unknown;
+
+    return mVoxels[index];
+}
+
+VoxelType* ChunkVoxels::GetData() noexcept
+{
+    return mVoxels;
+}
+
+const VoxelType* ChunkVoxels::GetData() const noexcept
+{
+    return mVoxels;
+}
+
+bool ChunkVoxels::LoadFromFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    if (!ChunkSerializer::Deserialize(data, mVoxels))
+    {
+        LOG_W("Chunk file \"" << fileName << "\" is corrupted.");
+        return false;
+    }
+
+    return true;
+}
+
+bool ChunkVoxels::SaveToFile(const std::string& fileName, ChunkCompression compression) const
+{
+    std::vector<unsigned char> data;
+    ChunkSerializer::Serialize(mVoxels, compression, data);
+
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        LOG_E("Failed to open file \"" << fileName << "\" for writing.");
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!file)
+    {
+        LOG_E("Writing to file \"" << fileName << "\" failed.");
+        return false;
+    }
+
+    return true;
+}
+
+bool ChunkVoxels::CalculateIndex(size_t x, size_t y, size_t z, size_t& index) const noexcept
+{
+    if ((x >= CHUNK_X) || (y >= CHUNK_Y) || (z >= CHUNK_Z))
+    {
+        LOG_W("Chunk coordinates [" << x << ", " << y << ", " << z
+              << "] exceed available Chunk dimensions! (which are ["
+              << CHUNK_X << ", " << CHUNK_Y << ", " << CHUNK_Z << "])");
+        return false;
+    }
+
+    // Convert 3D coordinates to a 1D array index. This way the one-dimensional array,
+    // which is easily accessible by Renderer, can be used as a 3D array.
+    index = x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Voxels declaration.
+ */
+
+#ifndef __TERRAIN_CHUNKVOXELS_HPP__
+#define __TERRAIN_CHUNKVOXELS_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+#include "ChunkSerializer.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Voxel storage of a single chunk.
+ *
+ * Voxels are kept in a one-dimensional array, index = x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z.
+ * This way X slices of the chunk are contiguous in memory, which is the layout expected by
+ * TerrainGenerator, ChunkSerializer and ChunkMesher.
+ *
+ * The class has no dependency on Renderer, so it can be used without an OpenGL context.
+ */
+class ChunkVoxels
+{
+public:
+    /**
+     * Creates a chunk filled with VoxelType::Air.
+     */
+    ChunkVoxels();
+
+    /**
+     * Set voxel at [@p x, @p y, @p z] to @p voxel.
+     *
+     * @remarks Exceeding voxel array dimensions should not happen, however to spare us an access
+     * violation when it happens, the function will produce a warning log and will return without
+     * any modifications done to voxel array.
+     */
+    void SetVoxel(size_t x, size_t y, size_t z, VoxelType voxel) noexcept;
+
+    /**
+     * Retrieve voxel at [@p x, @p y, @p z].
+     *
+     * @return Voxel type residing at given coordinates, or VoxelType::Unknown if coordinates
+     * exceed voxel array dimensions.
+     */
+    VoxelType GetVoxel(size_t x, size_t y, size_t z) const noexcept;
+
+    /**
+     * Acquire raw array of CHUNK_VOXEL_COUNT voxels.
+     */
+    VoxelType* GetData() noexcept;
+    const VoxelType* GetData() const noexcept;
+
+    /**
+     * Load voxels from a file written by SaveToFile().
+     *
+     * @return True on success. False if file does not exist or is corrupted, in which case
+     * voxels are left in an undefined state.
+     */
+    bool LoadFromFile(const std::string& fileName);
+
+    /**
+     * Write voxels to a file, replacing its previous contents.
+     *
+     * @param fileName    Path to the file.
+     * @param compression Compression method used for saved data.
+     * @return True on success, false otherwise.
+     */
+    bool SaveToFile(const std::string& fileName, ChunkCompression compression) const;
+
+private:
+    /**
+     * Translates three coordinates to a single index inside mVoxels array. Additionally checks if
+     * coordinates are correct and returns an error if they exceed mVoxels dimensions.
+     *
+     * @return True on success, false if index has exceeded the bounds of mVoxels array.
+     */
+    bool CalculateIndex(size_t x, size_t y, size_t z, size_t& index) const noexcept;
+
+    VoxelType mVoxels[CHUNK_VOXEL_COUNT];
+};
+
+#endif // __TERRAIN_CHUNKVOXELS_HPP__
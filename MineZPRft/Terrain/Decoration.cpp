@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain decoration definitions.
+ */
+
+#include "Decoration.hpp"
+
+#include "TerrainGenerator.hpp"
+#include "Common/Logger.hpp"
+
+
+DecorationQueue::DecorationQueue()
+    : mPendingCount(0)
+{
+}
+
+void DecorationQueue::Attach(int chunkX, int chunkZ, VoxelType* voxels)
+{
+    LockType lock(mMutex);
+
+    ChunkKeyType key(chunkX, chunkZ);
+    mAttached[key] = voxels;
+
+    auto pendingIt = mPending.find(key);
+    if (pendingIt == mPending.end())
+        return;
+
+    for (const auto& write : pendingIt->second)
+        PlaceDecoration(voxels[write.index], write.voxel);
+
+    LOG_D("Chunk [" << chunkX << ", " << chunkZ << "] received " << pendingIt->second.size()
+          << " queued decoration voxels.");
+
+    mPendingCount -= pendingIt->second.size();
+    mPending.erase(pendingIt);
+}
+
+void DecorationQueue::Submit(const std::vector<DecorationWrite>& writes)
+{
+    LockType lock(mMutex);
+    SubmitLocked(writes);
+}
+
+bool DecorationQueue::Decorate(const TerrainGenerator& generator, int chunkX, int chunkZ)
+{
+    std::vector<DecorationWrite> writes;
+
+    LockType lock(mMutex);
+
+    auto attachedIt = mAttached.find(ChunkKeyType(chunkX, chunkZ));
+    if (attachedIt == mAttached.end())
+        return false;
+
+    generator.Decorate(attachedIt->second, chunkX, chunkZ, writes);
+    SubmitLocked(writes);
+    return true;
+}
+
+size_t DecorationQueue::GetPendingCount() const
+{
+    LockType lock(mMutex);
+    return mPendingCount;
+}
+
+void DecorationQueue::SubmitLocked(const std::vector<DecorationWrite>& writes)
+{
+    // Consecutive writes mostly land in the same chunk, so look it up only when target changes
+    ChunkKeyType key;
+    VoxelType* voxels = nullptr;
+    bool found = false;
+
+    for (const auto& write : writes)
+    {
+        ChunkKeyType writeKey(write.chunkX, write.chunkZ);
+        if (!found || writeKey != key)
+        {
+            key = writeKey;
+            auto attachedIt = mAttached.find(key);
+            voxels = (attachedIt == mAttached.end()) ? nullptr : attachedIt->second;
+            found = true;
+        }
+
+        if (voxels)
+        {
+            PlaceDecoration(voxels[write.index], write.voxel);
+        }
+        else
+        {
+            mPending[key].push_back(write);
+            mPendingCount++;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain decoration declarations.
+ */
+
+#ifndef __TERRAIN_DECORATION_HPP__
+#define __TERRAIN_DECORATION_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class TerrainGenerator;
+
+/**
+ * Single voxel placed by a decoration (ex. a part of a tree). Decorations can reach over chunk's
+ * border, so every write carries coordinates of the chunk it lands in.
+ */
+struct DecorationWrite
+{
+    int chunkX;         ///< X coordinate of target chunk in the world.
+    int chunkZ;         ///< Z coordinate of target chunk in the world.
+    uint32_t index;     ///< Index of voxel inside target chunk's voxel array.
+    VoxelType voxel;    ///< Placed voxel.
+};
+
+/**
+ * Place decoration voxel @p voxel over @p target.
+ *
+ * Decorations never replace terrain. Leaves grow only in the air and wood replaces both air and
+ * leaves. This way the final voxel does not depend on the order in which overlapping decorations
+ * were placed, nor on how many times they were placed.
+ */
+inline void PlaceDecoration(VoxelType& target, VoxelType voxel) noexcept
+{
+    if (target == VoxelType::Air || (target == VoxelType::Leaves && voxel == VoxelType::Wood))
+        target = voxel;
+}
+
+/**
+ * Routes decoration writes to chunks they belong to.
+ *
+ * Chunk is attached to the queue once its terrain is complete. Writes to attached chunks are
+ * applied right away, while writes to chunks which are not attached yet wait in the queue and are
+ * applied when the chunk gets attached. Thus decorations crossing chunk borders end up complete,
+ * no matter in which order chunks are generated and decorated.
+ *
+ * All methods can be called from generator threads and main thread at once. Voxels of attached
+ * chunks are modified only under queue's lock.
+ */
+class DecorationQueue
+{
+public:
+    typedef std::pair<int, int> ChunkKeyType;
+
+    DecorationQueue();
+
+    /**
+     * Mark chunk [@p chunkX, @p chunkZ] as terrain-complete and apply writes waiting for it.
+     *
+     * @param chunkX Chunk's X coordinate in the world.
+     * @param chunkZ Chunk's Z coordinate in the world.
+     * @param voxels Chunk's array of CHUNK_VOXEL_COUNT voxels. Must stay valid as long as the
+     *               queue is used.
+     */
+    void Attach(int chunkX, int chunkZ, VoxelType* voxels);
+
+    /**
+     * Place @p writes into attached chunks, queue the rest.
+     */
+    void Submit(const std::vector<DecorationWrite>& writes);
+
+    /**
+     * Decorate attached chunk [@p chunkX, @p chunkZ] using @p generator and submit the result.
+     *
+     * @return False if chunk is not attached, true otherwise.
+     *
+     * Chunk's voxels are read under queue's lock, so decorations of neighbouring chunks can
+     * safely run in parallel.
+     */
+    bool Decorate(const TerrainGenerator& generator, int chunkX, int chunkZ);
+
+    /**
+     * Acquire amount of writes waiting for their chunks to be attached.
+     */
+    size_t GetPendingCount() const;
+
+private:
+    typedef std::unique_lock<std::mutex> LockType;
+
+    void SubmitLocked(const std::vector<DecorationWrite>& writes);
+
+    std::map<ChunkKeyType, VoxelType*> mAttached;
+    std::map<ChunkKeyType, std::vector<DecorationWrite>> mPending;
+    size_t mPendingCount;
+    mutable std::mutex mMutex;
+};
+
+#endif // __TERRAIN_DECORATION_HPP__
@@ -0,0 +1,11 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Common definitions for Terrain
+ */
+
+#include "Defines.hpp"
+
+// TODO Get rid of CHUNK_* consts. They should be customizable.
+// TODO Consider moving CHUNK_DIR to user home directory
+const std::string CHUNK_DIR = "ChunkBank";
@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Common declarations for Terrain
+ */
+
+#ifndef __TERRAIN_DEFINES_HPP__
+#define __TERRAIN_DEFINES_HPP__
+
+#include <string>
+
+/**
+ * Chunk dimensions.
+ * Will be useful when measuring performance between specific chunk sizes.
+ */
+#define CHUNK_X 32
+#define CHUNK_Y 128
+#define CHUNK_Z 32
+
+/**
+ * Amount of voxels in Chunk's 1D voxel array.
+ */
+#define CHUNK_VOXEL_COUNT (CHUNK_X * CHUNK_Y * CHUNK_Z)
+
+/**
+ * Maximum height of terrain generated by heightmap, above the stone base.
+ */
+#define HEIGHTMAP_HEIGHT 16
+
+/**
+ * Seed of the game world. Chunks in CHUNK_DIR, including pregenerated ones, are generated with it.
+ */
+#define WORLD_SEED 0u
+
+/**
+ * Directory in which Chunk files are saved.
+ */
+extern const std::string CHUNK_DIR;
+
+#endif // __TERRAIN_DEFINES_HPP__
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  FractalNoise class implementation.
+ */
+
+#include "FractalNoise.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Shifts every octave to a different part of noise space, otherwise all octaves would
+// share a lattice point at origin, creating a visible artifact
+const double OCTAVE_OFFSET = 71.37;
+
+} // namespace
+
+FractalDesc::FractalDesc()
+    : type(FractalType::FBM)
+    , octaves(1)
+    , frequency(1.0 / 32.0)
+    , lacunarity(2.0)
+    , gain(0.5)
+{
+}
+
+FractalNoise::FractalNoise()
+{
+}
+
+FractalNoise::FractalNoise(const FractalDesc& desc)
+    : mDesc(desc)
+{
+}
+
+template <typename T>
+void FractalNoise::GenerateTile(const NoiseGenerator& noiseGen, double originX, double originY,
+                                size_t width, size_t height, T* out) const
+{
+    size_t count = width * height;
+    std::vector<T> octave(count);
+    std::fill(out, out + count, static_cast<T>(0));
+
+    double frequency = mDesc.frequency;
+    T amplitude = 1;
+    T amplitudeSum = 0;
+
+    for (unsigned int i = 0; i < mDesc.octaves; ++i)
+    {
+        noiseGen.Noise2DTile(static_cast<T>(originX * frequency + i * OCTAVE_OFFSET),
+                             static_cast<T>(originY * frequency + i * OCTAVE_OFFSET),
+                             static_cast<T>(frequency), width, height, octave.data());
+
+        if (mDesc.type == FractalType::Ridged)
+        {
+            for (size_t j = 0; j < count; ++j)
+            {
+                T ridge = 1 - std::abs(octave[j]);
+                out[j] += amplitude * ridge * ridge;
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < count; ++j)
+                out[j] += amplitude * octave[j];
+        }
+
+        amplitudeSum += amplitude;
+        frequency *= mDesc.lacunarity;
+        amplitude *= static_cast<T>(mDesc.gain);
+    }
+
+    if (amplitudeSum == 0)
+        return;
+
+    // Normalize the result back to -1..1 range. Ridges sum up to 0..1, so they are stretched.
+    if (mDesc.type == FractalType::Ridged)
+        for (size_t j = 0; j < count; ++j)
+            out[j] = out[j] / amplitudeSum * 2 - 1;
+    else
+        for (size_t j = 0; j < count; ++j)
+            out[j] /= amplitudeSum;
+}
+
+const FractalDesc& FractalNoise::GetDesc() const
+{
+    return mDesc;
+}
+
+// Fractal noise is used only with these scalar types
+template void FractalNoise::GenerateTile<float>(const NoiseGenerator& noiseGen, double originX,
+                                                double originY, size_t width, size_t height,
+                                                float* out) const;
+template void FractalNoise::GenerateTile<double>(const NoiseGenerator& noiseGen, double originX,
+                                                 double originY, size_t width, size_t height,
+                                                 double* out) const;
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  FractalNoise class declaration.
+ */
+
+#pragma once
+
+#include "NoiseGenerator.hpp"
+
+#include <cstddef>
+
+/**
+ * Ways of combining octaves in FractalNoise.
+ */
+enum class FractalType: unsigned char
+{
+    FBM = 0,    ///< Fractal Brownian motion - plain sum of octaves, rolling hills.
+    Ridged,     ///< Sum of inverted absolute values of octaves - sharp ridges and valleys.
+};
+
+/**
+ * Parameters of FractalNoise.
+ */
+struct FractalDesc
+{
+    FractalType type;       ///< Octave combinator.
+    unsigned int octaves;   ///< Amount of noise layers summed together.
+    double frequency;       ///< Frequency of the first octave, in noise periods per voxel.
+    double lacunarity;      ///< Frequency multiplier between consecutive octaves.
+    double gain;            ///< Amplitude multiplier between consecutive octaves.
+
+    /**
+     * Defaults to a single octave with 32 voxels long period.
+     */
+    FractalDesc();
+};
+
+/**
+ * Class used for multi-octave 2D noise generation.
+ */
+class FractalNoise
+{
+private:
+    FractalDesc mDesc;
+
+public:
+    FractalNoise();
+    explicit FractalNoise(const FractalDesc& desc);
+
+    /**
+     * Generate fractal noise for a tile of voxel columns
+     * @param  noiseGen generator of each octave
+     * @param  originX  position of the first column on x axis, in voxels
+     * @param  originY  position of the first column on y axis, in voxels
+     * @param  width    amount of columns along x axis
+     * @param  height   amount of columns along y axis
+     * @param  out      output array of width * height values, in -1..1 range
+     *
+     * Each octave is generated for the whole tile at once with NoiseGenerator::Noise2DTile(),
+     * in precision of scalar type T of @p out - float or double. Origin is given in double, so
+     * tiles far from world center stay aligned with each other in either precision.
+     */
+    template <typename T>
+    void GenerateTile(const NoiseGenerator& noiseGen, double originX, double originY,
+                      size_t width, size_t height, T* out) const;
+
+    /**
+     * Get parameters used by this generator
+     */
+    const FractalDesc& GetDesc() const;
+};
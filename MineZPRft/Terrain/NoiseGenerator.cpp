@@ -5,148 +5,426 @@
  */
 
 #include "NoiseGenerator.hpp"
+#include "NoiseKernels.hpp"
 
-NoiseGenerator::NoiseGenerator()
-{
-    // Initialize default permutation table
-    mPermutationTable = {151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96,
-                        53, 194, 233, 7, 225, 140, 36, 103, 30, 69, 142, 8,
-                        99, 37, 240, 21, 10, 23, 190, 6, 148, 247, 120,
-                        234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117,
-                        35, 11, 32, 57, 177, 33, 88, 237, 149, 56, 87, 174,
-                        20, 125, 136, 171, 168, 68, 175, 74, 165, 71, 134,
-                        139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229,
-                        122, 60, 211, 133, 230, 220, 105, 92, 41, 55, 46,
-                        245, 40, 244, 102, 143, 54, 65, 25, 63, 161, 1,
-                        216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
-                        200, 196, 135, 130, 116, 188, 159, 86, 164, 100,
-                        109, 198, 173, 186, 3, 64, 52, 217, 226, 250, 124,
-                        123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
-                        207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28,
-                        42, 223, 183, 170, 213, 119, 248, 152, 2, 44, 154,
-                        163, 70, 221, 153, 101, 155, 167, 43, 172, 9, 129,
-                        22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232,
-                        178, 185, 112, 104, 218, 246, 97, 228, 251, 34,
-                        242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
-                        81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214,
-                        31, 181, 199, 106, 157, 184, 84, 204, 176, 115,
-                        121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
-                        222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78,
-                        66, 215, 61, 156, 180};
+#include "Common/Common.hpp"
 
-    // Fill out the rest of the table
-    auto begin = mPermutationTable.begin();
-    auto end = mPermutationTable.end();
-    mPermutationTable.insert(end, begin, end);
-}
+#include <algorithm>
+
+namespace {
 
-NoiseGenerator::~NoiseGenerator()
+// Reference permutation table from Ken Perlin's implementation of improved noise
+const int REFERENCE_PERMUTATION[] = {
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225, 140, 36, 103, 30, 69,
+    142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148, 247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219,
+    203, 117, 35, 11, 32, 57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122, 60, 211, 133, 230,
+    220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54, 65, 25, 63, 161, 1, 216, 80, 73, 209, 76,
+    132, 187, 208, 89, 18, 169, 200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173,
+    186, 3, 64, 52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212, 207, 206,
+    59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213, 119, 248, 152, 2, 44, 154, 163,
+    70, 221, 153, 101, 155, 167, 43, 172, 9, 129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232,
+    178, 185, 112, 104, 218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162,
+    241, 81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157, 184, 84, 204,
+    176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93, 222, 114, 67, 29, 24, 72, 243, 141,
+    128, 195, 78, 66, 215, 61, 156, 180
+};
+
+// MurmurHash3 finalizer - every input bit affects low bits picking the gradient
+uint32_t MixHash(uint32_t h)
 {
+    h ^= h >> 16;
+    h *= NoiseKernels::HASH_MIX_1;
+    h ^= h >> 13;
+    h *= NoiseKernels::HASH_MIX_2;
+    h ^= h >> 16;
+    return h;
 }
 
-NoiseGenerator& NoiseGenerator::GetInstance()
+// Columns of Noise2DTile() processed at once. Chunk-sized tiles fit in a single block.
+const size_t TILE_COLUMN_BLOCK = 64;
+
+} // namespace
+
+NoiseGenerator::NoiseGenerator(uint32_t seed, NoiseBackend backend)
+    : mSeed(seed)
+    , mHashSeed(seed * NoiseKernels::HASH_PRIME_SEED)
+    , mBackend(backend)
 {
-    static NoiseGenerator instance;
-    return instance;
+    const int half = NOISE_PERMUTATION_SIZE / 2;
+    int* begin = mPermutationTable;
+    int* end = mPermutationTable + half;
+
+    if (seed == 0)
+    {
+        std::copy(REFERENCE_PERMUTATION, REFERENCE_PERMUTATION + half, begin);
+    }
+    else
+    {
+        // Produce values 0 - 255
+        std::iota(begin, end, 0);
+
+        // Shuffle them
+        std::default_random_engine engine(seed);
+        std::shuffle(begin, end, engine);
+    }
+
+    // Fill out the rest of the table
+    std::copy(begin, end, end);
+
+    // Pick the widest kernel CPU can handle
+    if (IsCPUFeatureSupported(CPUFeature::AVX2))
+        mSupportedSIMD = NoiseSIMD::AVX2;
+    else if (IsCPUFeatureSupported(CPUFeature::SSE41))
+        mSupportedSIMD = NoiseSIMD::SSE4;
+    else
+        mSupportedSIMD = NoiseSIMD::Scalar;
 }
 
 // Cross-fade ( S curve ) function
-double NoiseGenerator::Fade(double t) const
+template <typename T>
+T NoiseGenerator::Fade(T t) const
 {
     return t * t * t * (t * (t * 6 - 15) + 10);
 }
 
 // TODO consider moving to Math library
 // Linear interpolation function
-double NoiseGenerator::Lerp(double t, double a, double b) const
+template <typename T>
+T NoiseGenerator::Lerp(T t, T a, T b) const
 {
     return a + t * (b - a);
 }
 
 // Function that returns uniformly random values of x,y,z via given hash value
-double NoiseGenerator::Grad(int hash, double x, double y, double z) const
+template <typename T>
+T NoiseGenerator::Grad(int hash, T x, T y, T z) const
 {
     // Get lower 4 bits of hash code instead of making modulos
     int h = hash & 15;
 
     // Convert them into 12 gradient directions
-    double u = h < 8 ? x : y;
-    double v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+    T u = h < 8 ? x : y;
+    T v = h < 4 ? y : h == 12 || h == 14 ? x : z;
 
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
+// 2D variant of Grad() - picks one of 8 directions (4 diagonal, 4 axial)
+template <typename T>
+T NoiseGenerator::Grad2D(int hash, T x, T y) const
+{
+    switch (hash & 7)
+    {
+    case 0: return x + y;
+    case 1: return -x + y;
+    case 2: return x - y;
+    case 3: return -x - y;
+    case 4: return x;
+    case 5: return -x;
+    case 6: return y;
+    default: return -y;
+    }
+}
+
 // Helper function to make code readable
 int NoiseGenerator::Perm(int index) const
 {
     return mPermutationTable[index];
 }
 
-void NoiseGenerator::CustomPermutationTable(uint32_t seed)
+// Gradient hashes of 8 cube corners, corner [dx, dy, dz] is stored at dx + 2 * dy + 4 * dz
+void NoiseGenerator::CornerHashes(int X, int Y, int Z, int (&hashes)[8]) const
 {
-    // Initialize custom permutation table
-    mPermutationTable.clear();
-    mPermutationTable.resize(256);
-    auto begin = mPermutationTable.begin();
-    auto end = mPermutationTable.end();
+    if (mBackend == NoiseBackend::Hash)
+    {
+        // (X + 1) * PRIME equals X * PRIME + PRIME, so 3 multiplications cover all corners
+        uint32_t xa = static_cast<uint32_t>(X) * NoiseKernels::HASH_PRIME_X;
+        uint32_t ya = static_cast<uint32_t>(Y) * NoiseKernels::HASH_PRIME_Y;
+        uint32_t zs = static_cast<uint32_t>(Z) * NoiseKernels::HASH_PRIME_Z;
+        uint32_t xb = xa + NoiseKernels::HASH_PRIME_X;
+        uint32_t yb = ya + NoiseKernels::HASH_PRIME_Y;
+        uint32_t za = zs ^ mHashSeed;
+        uint32_t zb = (zs + NoiseKernels::HASH_PRIME_Z) ^ mHashSeed;
 
-    // Produce values 0 - 255
-    std::iota(begin, end, 0);
+        hashes[0] = static_cast<int>(MixHash(xa ^ ya ^ za));
+        hashes[1] = static_cast<int>(MixHash(xb ^ ya ^ za));
+        hashes[2] = static_cast<int>(MixHash(xa ^ yb ^ za));
+        hashes[3] = static_cast<int>(MixHash(xb ^ yb ^ za));
+        hashes[4] = static_cast<int>(MixHash(xa ^ ya ^ zb));
+        hashes[5] = static_cast<int>(MixHash(xb ^ ya ^ zb));
+        hashes[6] = static_cast<int>(MixHash(xa ^ yb ^ zb));
+        hashes[7] = static_cast<int>(MixHash(xb ^ yb ^ zb));
+        return;
+    }
 
-    // Shuffle them
-    std::default_random_engine engine(seed);
-    std::shuffle(begin, end, engine);
+    X &= 255;
+    Y &= 255;
+    Z &= 255;
 
-    // Fill out the rest of the table
-    mPermutationTable.insert(end, begin, end);
+    int A = Perm(X) + Y;
+    int AA = Perm(A) + Z;
+    int AB = Perm(A + 1) + Z;
+    int B = Perm(X + 1) + Y;
+    int BA = Perm(B) + Z;
+    int BB = Perm(B + 1) + Z;
+
+    hashes[0] = Perm(AA);
+    hashes[1] = Perm(BA);
+    hashes[2] = Perm(AB);
+    hashes[3] = Perm(BB);
+    hashes[4] = Perm(AA + 1);
+    hashes[5] = Perm(BA + 1);
+    hashes[6] = Perm(AB + 1);
+    hashes[7] = Perm(BB + 1);
+}
+
+// Gradient hashes of 4 square corners, corner [dx, dy] is stored at dx + 2 * dy
+void NoiseGenerator::CornerHashes2D(int X, int Y, int (&hashes)[4]) const
+{
+    if (mBackend == NoiseBackend::Hash)
+    {
+        // Same as CornerHashes() with Z = 0
+        uint32_t xa = static_cast<uint32_t>(X) * NoiseKernels::HASH_PRIME_X;
+        uint32_t ys = static_cast<uint32_t>(Y) * NoiseKernels::HASH_PRIME_Y;
+        uint32_t xb = xa + NoiseKernels::HASH_PRIME_X;
+        uint32_t ya = ys ^ mHashSeed;
+        uint32_t yb = (ys + NoiseKernels::HASH_PRIME_Y) ^ mHashSeed;
+
+        hashes[0] = static_cast<int>(MixHash(xa ^ ya));
+        hashes[1] = static_cast<int>(MixHash(xb ^ ya));
+        hashes[2] = static_cast<int>(MixHash(xa ^ yb));
+        hashes[3] = static_cast<int>(MixHash(xb ^ yb));
+        return;
+    }
+
+    X &= 255;
+    Y &= 255;
+
+    int A = Perm(X) + Y;
+    int B = Perm(X + 1) + Y;
+
+    hashes[0] = Perm(A);
+    hashes[1] = Perm(B);
+    hashes[2] = Perm(A + 1);
+    hashes[3] = Perm(B + 1);
+}
+
+uint32_t NoiseGenerator::GetSeed() const
+{
+    return mSeed;
+}
+
+NoiseBackend NoiseGenerator::GetBackend() const
+{
+    return mBackend;
 }
 
-double NoiseGenerator::Noise(double x, double y, double z) const
+template <typename T>
+T NoiseGenerator::Noise(T x, T y, T z) const
 {
     // Find 8point cube that contains the given point
-    int X = static_cast<int>(floor(x)) & 255;
-    int Y = static_cast<int>(floor(y)) & 255;
-    int Z = static_cast<int>(floor(z)) & 255;
+    int X = static_cast<int>(std::floor(x));
+    int Y = static_cast<int>(std::floor(y));
+    int Z = static_cast<int>(std::floor(z));
 
     // Find relative X, Y, Z of the point in this cube
-    x -= floor(x);
-    y -= floor(y);
-    z -= floor(z);
+    x -= std::floor(x);
+    y -= std::floor(y);
+    z -= std::floor(z);
 
     // Compute cross-fade curves in each of x, y and z
-    double u = Fade(x);
-    double v = Fade(y);
-    double w = Fade(z);
+    T u = Fade(x);
+    T v = Fade(y);
+    T w = Fade(z);
 
     // Hash coordinates of the 8 cube corners
-    int A = Perm(X) + Y;
-    int AA = Perm(A) + Z;
-    int AB = Perm(A + 1) + Z;
-    int B = Perm(X + 1) + Y;
-    int BA = Perm(B) + Z;
-    int BB = Perm(B + 1) + Z;
+    int h[8];
+    CornerHashes(X, Y, Z, h);
 
     // Time to interpolate results from the 8 corners of the cube
     //     Possible interpolations in X axis (4 of them)
-    double x11 = Lerp(u, Grad(Perm(AA), x, y, z),
-                      Grad(Perm(BA), x - 1, y, z));
+    T x11 = Lerp(u, Grad(h[0], x, y, z),
+                      Grad(h[1], x - 1, y, z));
 
-    double x12 = Lerp(u, Grad(Perm(AB), x, y - 1, z),
-                      Grad(Perm(BB), x - 1, y - 1, z));
+    T x12 = Lerp(u, Grad(h[2], x, y - 1, z),
+                      Grad(h[3], x - 1, y - 1, z));
 
-    double x21 = Lerp(u, Grad(Perm(AA + 1), x, y, z - 1),
-                      Grad(Perm(BA + 1), x - 1, y, z - 1));
+    T x21 = Lerp(u, Grad(h[4], x, y, z - 1),
+                      Grad(h[5], x - 1, y, z - 1));
 
-    double x22 = Lerp(u, Grad(Perm(AB + 1), x, y - 1, z - 1),
-                      Grad(Perm(BB + 1), x - 1, y - 1, z - 1));
+    T x22 = Lerp(u, Grad(h[6], x, y - 1, z - 1),
+                      Grad(h[7], x - 1, y - 1, z - 1));
 
     //     Possible interpolations in Y axis (2 of them)
-    double y1 = Lerp(v, x11, x12);
-    double y2 = Lerp(v, x21, x22);
+    T y1 = Lerp(v, x11, x12);
+    T y2 = Lerp(v, x21, x22);
 
     //     Possible interpolations in Z axis (1 of them)
-    double z1 = Lerp(w, y1, y2);
+    T z1 = Lerp(w, y1, y2);
 
     // Return blended result from the 8 corners of the cube
     return z1;
-}
\ No newline at end of file
+}
+
+template <typename T>
+T NoiseGenerator::Noise2D(T x, T y) const
+{
+    // Find 4point square that contains the given point
+    int X = static_cast<int>(std::floor(x));
+    int Y = static_cast<int>(std::floor(y));
+
+    // Find relative X, Y of the point in this square
+    x -= std::floor(x);
+    y -= std::floor(y);
+
+    // Compute cross-fade curves in each of x and y
+    T u = Fade(x);
+    T v = Fade(y);
+
+    // Hash coordinates of the 4 square corners
+    int h[4];
+    CornerHashes2D(X, Y, h);
+
+    // Interpolate results from the 4 corners of the square
+    T x1 = Lerp(u, Grad2D(h[0], x, y), Grad2D(h[1], x - 1, y));
+    T x2 = Lerp(u, Grad2D(h[2], x, y - 1), Grad2D(h[3], x - 1, y - 1));
+
+    return Lerp(v, x1, x2);
+}
+
+template <typename T>
+void NoiseGenerator::Noise2DTile(T x0, T y0, T step, size_t width, size_t height, T* out) const
+{
+    const bool hashed = (mBackend == NoiseBackend::Hash);
+
+    // Per-column data, shared by all rows of the tile. Columns keep the X-dependent half of
+    // corner hashes - permuted X for Permutation backend, X * HASH_PRIME_X for Hash backend.
+    // Kept on stack, so wider tiles are generated in blocks of columns.
+    uint32_t columnA[TILE_COLUMN_BLOCK];
+    uint32_t columnB[TILE_COLUMN_BLOCK];
+    T columnX[TILE_COLUMN_BLOCK];
+    T columnU[TILE_COLUMN_BLOCK];
+
+    for (size_t first = 0; first < width; first += TILE_COLUMN_BLOCK)
+    {
+        size_t blockWidth = std::min(width - first, TILE_COLUMN_BLOCK);
+        for (size_t i = 0; i < blockWidth; ++i)
+        {
+            T x = x0 + (first + i) * step;
+            int X = static_cast<int>(std::floor(x));
+            columnX[i] = x - std::floor(x);
+            columnU[i] = Fade(columnX[i]);
+            if (hashed)
+            {
+                columnA[i] = static_cast<uint32_t>(X) * NoiseKernels::HASH_PRIME_X;
+                columnB[i] = columnA[i] + NoiseKernels::HASH_PRIME_X;
+            }
+            else
+            {
+                columnA[i] = Perm(X & 255);
+                columnB[i] = Perm((X & 255) + 1);
+            }
+        }
+
+        for (size_t j = 0; j < height; ++j)
+        {
+            T y = y0 + j * step;
+            int Y = static_cast<int>(std::floor(y));
+            y -= std::floor(y);
+            T v = Fade(y);
+
+            // Y-dependent half of corner hashes, for both rows of the square
+            uint32_t rowA, rowB;
+            if (hashed)
+            {
+                uint32_t ys = static_cast<uint32_t>(Y) * NoiseKernels::HASH_PRIME_Y;
+                rowA = ys ^ mHashSeed;
+                rowB = (ys + NoiseKernels::HASH_PRIME_Y) ^ mHashSeed;
+            }
+            else
+            {
+                rowA = Y & 255;
+                rowB = rowA + 1;
+            }
+
+            T* row = out + j * width + first;
+            for (size_t i = 0; i < blockWidth; ++i)
+            {
+                int h[4];
+                if (hashed)
+                {
+                    h[0] = static_cast<int>(MixHash(columnA[i] ^ rowA));
+                    h[1] = static_cast<int>(MixHash(columnB[i] ^ rowA));
+                    h[2] = static_cast<int>(MixHash(columnA[i] ^ rowB));
+                    h[3] = static_cast<int>(MixHash(columnB[i] ^ rowB));
+                }
+                else
+                {
+                    h[0] = Perm(columnA[i] + rowA);
+                    h[1] = Perm(columnB[i] + rowA);
+                    h[2] = Perm(columnA[i] + rowB);
+                    h[3] = Perm(columnB[i] + rowB);
+                }
+
+                T x = columnX[i];
+                T x1 = Lerp(columnU[i], Grad2D(h[0], x, y), Grad2D(h[1], x - 1, y));
+                T x2 = Lerp(columnU[i], Grad2D(h[2], x, y - 1), Grad2D(h[3], x - 1, y - 1));
+
+                row[i] = Lerp(v, x1, x2);
+            }
+        }
+    }
+}
+
+void NoiseGenerator::NoiseBatch(const float* xs, const float* ys, const float* zs, float* out,
+                                size_t n) const
+{
+    NoiseBatch(xs, ys, zs, out, n, mSupportedSIMD);
+}
+
+void NoiseGenerator::NoiseBatch(const float* xs, const float* ys, const float* zs, float* out,
+                                size_t n, NoiseSIMD simd) const
+{
+    if (simd > mSupportedSIMD)
+        simd = mSupportedSIMD;
+
+    // Kernels process whole vectors only, the tail is left for scalar code
+    size_t done = 0;
+    switch (simd)
+    {
+    case NoiseSIMD::AVX2:
+        if (mBackend == NoiseBackend::Hash)
+            done = NoiseKernels::BatchHashAVX2(mSeed, xs, ys, zs, out, n);
+        else
+            done = NoiseKernels::BatchAVX2(mPermutationTable, xs, ys, zs, out, n);
+        break;
+    case NoiseSIMD::SSE4:
+        if (mBackend == NoiseBackend::Hash)
+            done = NoiseKernels::BatchHashSSE4(mSeed, xs, ys, zs, out, n);
+        else
+            done = NoiseKernels::BatchSSE4(mPermutationTable, xs, ys, zs, out, n);
+        break;
+    case NoiseSIMD::Scalar:
+        break;
+    }
+
+    for (size_t i = done; i < n; ++i)
+        out[i] = Noise(xs[i], ys[i], zs[i]);
+}
+
+NoiseSIMD NoiseGenerator::GetSupportedSIMD() const
+{
+    return mSupportedSIMD;
+}
+
+// Noise is used only with these scalar types
+template float NoiseGenerator::Noise<float>(float x, float y, float z) const;
+template double NoiseGenerator::Noise<double>(double x, double y, double z) const;
+template float NoiseGenerator::Noise2D<float>(float x, float y) const;
+template double NoiseGenerator::Noise2D<double>(double x, double y) const;
+template void NoiseGenerator::Noise2DTile<float>(float x0, float y0, float step, size_t width,
+                                                 size_t height, float* out) const;
+template void NoiseGenerator::Noise2DTile<double>(double x0, double y0, double step,
+                                                  size_t width, size_t height,
+                                                  double* out) const;
@@ -12,39 +12,79 @@
 #include <numeric>
 #include <random>
 #include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Instruction sets used by NoiseGenerator::NoiseBatch() kernels.
+ */
+enum class NoiseSIMD: unsigned char
+{
+    Scalar = 0, ///< Plain C++, available everywhere.
+    SSE4,       ///< 4 points at once, SSE 4.1.
+    AVX2,       ///< 8 points at once, AVX2.
+};
+
+/**
+ * Source of gradients assigned to lattice points.
+ */
+enum class NoiseBackend: unsigned char
+{
+    Permutation = 0, ///< Ken Perlin's permutation table, indexed by lattice coordinates. Noise
+                     ///< repeats every 256 units.
+    Hash,            ///< Integer hash of lattice coordinates and seed. Needs no table lookups, so
+                     ///< SIMD kernels work without gathers. Does not repeat.
+};
+
+/**
+ * Size of permutation table. 256 shuffled values, repeated twice to avoid wrapping indices.
+ */
+#define NOISE_PERMUTATION_SIZE 512
 
 /**
  * Class used for 3D Perlin noise generation.
+ *
+ * Noise is fully defined by seed passed on construction and never changes afterwards, so a single
+ * instance can be used by many threads at once. Instances with different seeds are independent.
  */
 class NoiseGenerator
 {
 private:
-    std::vector<int> mPermutationTable;
-
-    NoiseGenerator();
-    NoiseGenerator(const NoiseGenerator&) = delete;
-    NoiseGenerator(NoiseGenerator&&) = delete;
-    NoiseGenerator& operator=(const NoiseGenerator&) = delete;
-    NoiseGenerator& operator=(NoiseGenerator&&) = delete;
-    ~NoiseGenerator();
-
-    double Fade(double t) const;
-    double Lerp(double t, double a, double b) const;
-    double Grad(int hash, double x, double y, double z) const;
+    alignas(64) int mPermutationTable[NOISE_PERMUTATION_SIZE];
+    uint32_t mSeed;
+    uint32_t mHashSeed;
+    NoiseBackend mBackend;
+    NoiseSIMD mSupportedSIMD;
+
+    template <typename T> T Fade(T t) const;
+    template <typename T> T Lerp(T t, T a, T b) const;
+    template <typename T> T Grad(int hash, T x, T y, T z) const;
+    template <typename T> T Grad2D(int hash, T x, T y) const;
     int Perm(int index) const;
+    void CornerHashes(int X, int Y, int Z, int (&hashes)[8]) const;
+    void CornerHashes2D(int X, int Y, int (&hashes)[4]) const;
 
 public:
 
     /**
-     * Get NoiseGenerator instance
+     * Create noise with permutation table shuffled by given seed.
+     * @param  seed    custom seed, 0 selects the reference permutation table
+     * @param  backend source of lattice gradients
+     *
+     * Both backends produce noise of the same character, but different values - switching
+     * backend changes generated world just like switching seed does.
+     */
+    explicit NoiseGenerator(uint32_t seed = 0, NoiseBackend backend = NoiseBackend::Permutation);
+
+    /**
+     * Get seed used to create this noise
      */
-    static NoiseGenerator& GetInstance();
+    uint32_t GetSeed() const;
 
     /**
-     * Recreate permutation table using given seed.
-     * @param  seed custom seed
+     * Get source of lattice gradients used by this noise
      */
-    void CustomPermutationTable(uint32_t seed);
+    NoiseBackend GetBackend() const;
 
     /**
      * Generate Perlin noise for given point in unit cube
@@ -52,6 +92,64 @@ public:
      * @param  y position on y axis
      * @param  z position on z axis
      * @return generated random value
+     *
+     * Noise is evaluated in precision of scalar type T - float or double. Double is the
+     * reference, float is enough for terrain generation, where results are quantized anyway.
+     */
+    template <typename T>
+    T Noise(T x, T y, T z) const;
+
+    /**
+     * Generate Perlin noise for a batch of points
+     * @param  xs  positions on x axis
+     * @param  ys  positions on y axis
+     * @param  zs  positions on z axis
+     * @param  out output array for generated values
+     * @param  n   amount of points in each array
+     *
+     * Uses the fastest SIMD kernel supported by CPU. Results match Noise() up to float precision.
+     */
+    void NoiseBatch(const float* xs, const float* ys, const float* zs, float* out,
+                    size_t n) const;
+
+    /**
+     * Generate Perlin noise for a batch of points with chosen kernel
+     * @param  simd kernel to use. If CPU does not support it, best supported one is used instead.
+     *
+     * Remaining parameters are the same as in NoiseBatch() above.
+     */
+    void NoiseBatch(const float* xs, const float* ys, const float* zs, float* out, size_t n,
+                    NoiseSIMD simd) const;
+
+    /**
+     * Generate 2D Perlin noise for given point
+     * @param  x position on x axis
+     * @param  y position on y axis
+     * @return generated random value
+     *
+     * Cheaper than Noise(x, y, 0.0) - only 4 lattice corners are evaluated instead of 8.
+     */
+    template <typename T>
+    T Noise2D(T x, T y) const;
+
+    /**
+     * Generate 2D Perlin noise for a regular grid of points
+     * @param  x0     position of the first point on x axis
+     * @param  y0     position of the first point on y axis
+     * @param  step   distance between neighbouring points
+     * @param  width  amount of points along x axis
+     * @param  height amount of points along y axis
+     * @param  out    output array of width * height values, point [i, j] is stored at j * width + i
+     *
+     * Lattice cell and fade curve of each column and row are computed once per tile, instead of
+     * once per point. Results are equal to calling Noise2D() with the same scalar type for every
+     * point.
+     */
+    template <typename T>
+    void Noise2DTile(T x0, T y0, T step, size_t width, size_t height, T* out) const;
+
+    /**
+     * Get the fastest kernel supported by CPU
      */
-    double Noise(double x, double y, double z) const;
+    NoiseSIMD GetSupportedSIMD() const;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  SIMD kernels used by NoiseGenerator::NoiseBatch().
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Each kernel lives in its own source file, compiled with flags enabling its instruction set.
+ * Kernels must be called only if CPU supports their instruction set.
+ *
+ * All kernels implement the same algorithm as NoiseGenerator::Noise() in single precision, with
+ * either of NoiseBackend gradient sources.
+ * They process whole vectors only and return amount of points done, so the caller has to
+ * finish the remaining (less than vector width) points itself.
+ */
+namespace NoiseKernels {
+
+/**
+ * Constants of NoiseBackend::Hash lattice hash, shared by scalar code and kernels.
+ *
+ * Corner [X, Y, Z] gets gradient number Mix(X * PRIME_X ^ Y * PRIME_Y ^ Z * PRIME_Z ^ seed *
+ * PRIME_SEED), where Mix() is MurmurHash3 32-bit finalizer using MIX_1 and MIX_2. All arithmetic
+ * wraps around modulo 2^32.
+ */
+const uint32_t HASH_PRIME_X = 0x8da6b343u;
+const uint32_t HASH_PRIME_Y = 0xd8163841u;
+const uint32_t HASH_PRIME_Z = 0xcb1ab31fu;
+const uint32_t HASH_PRIME_SEED = 0x9e3779b1u;
+const uint32_t HASH_MIX_1 = 0x85ebca6bu;
+const uint32_t HASH_MIX_2 = 0xc2b2ae35u;
+
+/**
+ * Evaluate noise for 4 points at a time, using SSE 4.1.
+ * @param  perm permutation table of 512 entries
+ * @return amount of points processed
+ */
+size_t BatchSSE4(const int* perm, const float* xs, const float* ys, const float* zs, float* out,
+                 size_t n);
+
+/**
+ * Evaluate noise for 8 points at a time, using AVX2.
+ * @param  perm permutation table of 512 entries
+ * @return amount of points processed
+ */
+size_t BatchAVX2(const int* perm, const float* xs, const float* ys, const float* zs, float* out,
+                 size_t n);
+
+/**
+ * Evaluate hash-based noise for 4 points at a time, using SSE 4.1.
+ * @param  seed noise seed
+ * @return amount of points processed
+ */
+size_t BatchHashSSE4(uint32_t seed, const float* xs, const float* ys, const float* zs,
+                     float* out, size_t n);
+
+/**
+ * Evaluate hash-based noise for 8 points at a time, using AVX2.
+ * @param  seed noise seed
+ * @return amount of points processed
+ */
+size_t BatchHashAVX2(uint32_t seed, const float* xs, const float* ys, const float* zs,
+                     float* out, size_t n);
+
+} // namespace NoiseKernels
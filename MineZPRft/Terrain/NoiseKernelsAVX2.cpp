@@ -0,0 +1,190 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  AVX2 noise kernel. Must be compiled with AVX2 enabled.
+ */
+
+#include "NoiseKernels.hpp"
+
+#include <immintrin.h>
+
+namespace {
+
+__m256i Perm(const int* perm, __m256i index)
+{
+    return _mm256_i32gather_epi32(perm, index, 4);
+}
+
+__m256 Fade(__m256 t)
+{
+    __m256 poly = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    poly = _mm256_add_ps(_mm256_mul_ps(t, poly), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), poly);
+}
+
+__m256 Lerp(__m256 t, __m256 a, __m256 b)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+// Branchless version of NoiseGenerator::Grad()
+__m256 Grad(__m256i hash, __m256 x, __m256 y, __m256 z)
+{
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+
+    __m256 hLess8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+    __m256 hLess4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    __m256 h12or14 = _mm256_castsi256_ps(
+        _mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+
+    __m256 u = _mm256_blendv_ps(y, x, hLess8);
+    __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, h12or14), y, hLess4);
+
+    // Negate by flipping sign bits, selected by bits 0 and 1 of hash
+    __m256 uSign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 vSign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+
+    return _mm256_add_ps(_mm256_xor_ps(u, uSign), _mm256_xor_ps(v, vSign));
+}
+
+// Vector version of MurmurHash3 finalizer used by NoiseBackend::Hash
+__m256i MixHash(__m256i h)
+{
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(NoiseKernels::HASH_MIX_1)));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(NoiseKernels::HASH_MIX_2)));
+    return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+}
+
+// Corner hashes of NoiseBackend::Permutation, stored the same way as in NoiseGenerator
+struct PermutationCorners
+{
+    const int* perm;
+
+    void operator()(__m256i X, __m256i Y, __m256i Z, __m256i (&hashes)[8]) const
+    {
+        const __m256i mask = _mm256_set1_epi32(255);
+        const __m256i one = _mm256_set1_epi32(1);
+
+        X = _mm256_and_si256(X, mask);
+        Y = _mm256_and_si256(Y, mask);
+        Z = _mm256_and_si256(Z, mask);
+
+        __m256i A = _mm256_add_epi32(Perm(perm, X), Y);
+        __m256i AA = _mm256_add_epi32(Perm(perm, A), Z);
+        __m256i AB = _mm256_add_epi32(Perm(perm, _mm256_add_epi32(A, one)), Z);
+        __m256i B = _mm256_add_epi32(Perm(perm, _mm256_add_epi32(X, one)), Y);
+        __m256i BA = _mm256_add_epi32(Perm(perm, B), Z);
+        __m256i BB = _mm256_add_epi32(Perm(perm, _mm256_add_epi32(B, one)), Z);
+
+        hashes[0] = Perm(perm, AA);
+        hashes[1] = Perm(perm, BA);
+        hashes[2] = Perm(perm, AB);
+        hashes[3] = Perm(perm, BB);
+        hashes[4] = Perm(perm, _mm256_add_epi32(AA, one));
+        hashes[5] = Perm(perm, _mm256_add_epi32(BA, one));
+        hashes[6] = Perm(perm, _mm256_add_epi32(AB, one));
+        hashes[7] = Perm(perm, _mm256_add_epi32(BB, one));
+    }
+};
+
+// Corner hashes of NoiseBackend::Hash - arithmetic only, no memory accesses
+struct HashCorners
+{
+    __m256i seed;
+
+    void operator()(__m256i X, __m256i Y, __m256i Z, __m256i (&hashes)[8]) const
+    {
+        const __m256i primeX = _mm256_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_X));
+        const __m256i primeY = _mm256_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_Y));
+        const __m256i primeZ = _mm256_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_Z));
+
+        __m256i xa = _mm256_mullo_epi32(X, primeX);
+        __m256i ya = _mm256_mullo_epi32(Y, primeY);
+        __m256i zs = _mm256_mullo_epi32(Z, primeZ);
+        __m256i xb = _mm256_add_epi32(xa, primeX);
+        __m256i yb = _mm256_add_epi32(ya, primeY);
+        __m256i za = _mm256_xor_si256(zs, seed);
+        __m256i zb = _mm256_xor_si256(_mm256_add_epi32(zs, primeZ), seed);
+
+        hashes[0] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xa, ya), za));
+        hashes[1] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xb, ya), za));
+        hashes[2] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xa, yb), za));
+        hashes[3] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xb, yb), za));
+        hashes[4] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xa, ya), zb));
+        hashes[5] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xb, ya), zb));
+        hashes[6] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xa, yb), zb));
+        hashes[7] = MixHash(_mm256_xor_si256(_mm256_xor_si256(xb, yb), zb));
+    }
+};
+
+template <typename Corners>
+size_t Batch(const Corners& corners, const float* xs, const float* ys, const float* zs,
+             float* out, size_t n)
+{
+    const __m256 onef = _mm256_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+
+        // Find unit cube that contains the point and relative position inside it
+        __m256 floorX = _mm256_floor_ps(x);
+        __m256 floorY = _mm256_floor_ps(y);
+        __m256 floorZ = _mm256_floor_ps(z);
+        __m256i X = _mm256_cvttps_epi32(floorX);
+        __m256i Y = _mm256_cvttps_epi32(floorY);
+        __m256i Z = _mm256_cvttps_epi32(floorZ);
+        x = _mm256_sub_ps(x, floorX);
+        y = _mm256_sub_ps(y, floorY);
+        z = _mm256_sub_ps(z, floorZ);
+
+        __m256 u = Fade(x);
+        __m256 v = Fade(y);
+        __m256 w = Fade(z);
+
+        // Hash coordinates of the 8 cube corners
+        __m256i h[8];
+        corners(X, Y, Z, h);
+
+        __m256 x1 = _mm256_sub_ps(x, onef);
+        __m256 y1 = _mm256_sub_ps(y, onef);
+        __m256 z1 = _mm256_sub_ps(z, onef);
+
+        __m256 x11 = Lerp(u, Grad(h[0], x, y, z), Grad(h[1], x1, y, z));
+        __m256 x12 = Lerp(u, Grad(h[2], x, y1, z), Grad(h[3], x1, y1, z));
+        __m256 x21 = Lerp(u, Grad(h[4], x, y, z1), Grad(h[5], x1, y, z1));
+        __m256 x22 = Lerp(u, Grad(h[6], x, y1, z1), Grad(h[7], x1, y1, z1));
+
+        _mm256_storeu_ps(out + i, Lerp(w, Lerp(v, x11, x12), Lerp(v, x21, x22)));
+    }
+
+    return i;
+}
+
+} // namespace
+
+namespace NoiseKernels {
+
+size_t BatchAVX2(const int* perm, const float* xs, const float* ys, const float* zs, float* out,
+                 size_t n)
+{
+    PermutationCorners corners = { perm };
+    return Batch(corners, xs, ys, zs, out, n);
+}
+
+size_t BatchHashAVX2(uint32_t seed, const float* xs, const float* ys, const float* zs,
+                     float* out, size_t n)
+{
+    HashCorners corners = { _mm256_set1_epi32(static_cast<int>(seed * HASH_PRIME_SEED)) };
+    return Batch(corners, xs, ys, zs, out, n);
+}
+
+} // namespace NoiseKernels
@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  SSE 4.1 noise kernel. Must be compiled with SSE 4.1 enabled.
+ */
+
+#include "NoiseKernels.hpp"
+
+#include <smmintrin.h>
+
+namespace {
+
+// SSE has no gather instruction, so permutation table is read lane by lane
+__m128i Perm(const int* perm, __m128i index)
+{
+    return _mm_setr_epi32(perm[_mm_extract_epi32(index, 0)],
+                          perm[_mm_extract_epi32(index, 1)],
+                          perm[_mm_extract_epi32(index, 2)],
+                          perm[_mm_extract_epi32(index, 3)]);
+}
+
+__m128 Fade(__m128 t)
+{
+    __m128 poly = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    poly = _mm_add_ps(_mm_mul_ps(t, poly), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), poly);
+}
+
+__m128 Lerp(__m128 t, __m128 a, __m128 b)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+// Branchless version of NoiseGenerator::Grad()
+__m128 Grad(__m128i hash, __m128 x, __m128 y, __m128 z)
+{
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+
+    __m128 hLess8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128 hLess4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128 h12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                   _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+
+    __m128 u = _mm_blendv_ps(y, x, hLess8);
+    __m128 v = _mm_blendv_ps(_mm_blendv_ps(z, x, h12or14), y, hLess4);
+
+    // Negate by flipping sign bits, selected by bits 0 and 1 of hash
+    __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+
+    return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+}
+
+// Vector version of MurmurHash3 finalizer used by NoiseBackend::Hash
+__m128i MixHash(__m128i h)
+{
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+    h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(NoiseKernels::HASH_MIX_1)));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+    h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(NoiseKernels::HASH_MIX_2)));
+    return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+}
+
+// Corner hashes of NoiseBackend::Permutation, stored the same way as in NoiseGenerator
+struct PermutationCorners
+{
+    const int* perm;
+
+    void operator()(__m128i X, __m128i Y, __m128i Z, __m128i (&hashes)[8]) const
+    {
+        const __m128i mask = _mm_set1_epi32(255);
+        const __m128i one = _mm_set1_epi32(1);
+
+        X = _mm_and_si128(X, mask);
+        Y = _mm_and_si128(Y, mask);
+        Z = _mm_and_si128(Z, mask);
+
+        __m128i A = _mm_add_epi32(Perm(perm, X), Y);
+        __m128i AA = _mm_add_epi32(Perm(perm, A), Z);
+        __m128i AB = _mm_add_epi32(Perm(perm, _mm_add_epi32(A, one)), Z);
+        __m128i B = _mm_add_epi32(Perm(perm, _mm_add_epi32(X, one)), Y);
+        __m128i BA = _mm_add_epi32(Perm(perm, B), Z);
+        __m128i BB = _mm_add_epi32(Perm(perm, _mm_add_epi32(B, one)), Z);
+
+        hashes[0] = Perm(perm, AA);
+        hashes[1] = Perm(perm, BA);
+        hashes[2] = Perm(perm, AB);
+        hashes[3] = Perm(perm, BB);
+        hashes[4] = Perm(perm, _mm_add_epi32(AA, one));
+        hashes[5] = Perm(perm, _mm_add_epi32(BA, one));
+        hashes[6] = Perm(perm, _mm_add_epi32(AB, one));
+        hashes[7] = Perm(perm, _mm_add_epi32(BB, one));
+    }
+};
+
+// Corner hashes of NoiseBackend::Hash - arithmetic only, no memory accesses
+struct HashCorners
+{
+    __m128i seed;
+
+    void operator()(__m128i X, __m128i Y, __m128i Z, __m128i (&hashes)[8]) const
+    {
+        const __m128i primeX = _mm_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_X));
+        const __m128i primeY = _mm_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_Y));
+        const __m128i primeZ = _mm_set1_epi32(static_cast<int>(NoiseKernels::HASH_PRIME_Z));
+
+        __m128i xa = _mm_mullo_epi32(X, primeX);
+        __m128i ya = _mm_mullo_epi32(Y, primeY);
+        __m128i zs = _mm_mullo_epi32(Z, primeZ);
+        __m128i xb = _mm_add_epi32(xa, primeX);
+        __m128i yb = _mm_add_epi32(ya, primeY);
+        __m128i za = _mm_xor_si128(zs, seed);
+        __m128i zb = _mm_xor_si128(_mm_add_epi32(zs, primeZ), seed);
+
+        hashes[0] = MixHash(_mm_xor_si128(_mm_xor_si128(xa, ya), za));
+        hashes[1] = MixHash(_mm_xor_si128(_mm_xor_si128(xb, ya), za));
+        hashes[2] = MixHash(_mm_xor_si128(_mm_xor_si128(xa, yb), za));
+        hashes[3] = MixHash(_mm_xor_si128(_mm_xor_si128(xb, yb), za));
+        hashes[4] = MixHash(_mm_xor_si128(_mm_xor_si128(xa, ya), zb));
+        hashes[5] = MixHash(_mm_xor_si128(_mm_xor_si128(xb, ya), zb));
+        hashes[6] = MixHash(_mm_xor_si128(_mm_xor_si128(xa, yb), zb));
+        hashes[7] = MixHash(_mm_xor_si128(_mm_xor_si128(xb, yb), zb));
+    }
+};
+
+template <typename Corners>
+size_t Batch(const Corners& corners, const float* xs, const float* ys, const float* zs,
+             float* out, size_t n)
+{
+    const __m128 onef = _mm_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+
+        // Find unit cube that contains the point and relative position inside it
+        __m128 floorX = _mm_floor_ps(x);
+        __m128 floorY = _mm_floor_ps(y);
+        __m128 floorZ = _mm_floor_ps(z);
+        __m128i X = _mm_cvttps_epi32(floorX);
+        __m128i Y = _mm_cvttps_epi32(floorY);
+        __m128i Z = _mm_cvttps_epi32(floorZ);
+        x = _mm_sub_ps(x, floorX);
+        y = _mm_sub_ps(y, floorY);
+        z = _mm_sub_ps(z, floorZ);
+
+        __m128 u = Fade(x);
+        __m128 v = Fade(y);
+        __m128 w = Fade(z);
+
+        // Hash coordinates of the 8 cube corners
+        __m128i h[8];
+        corners(X, Y, Z, h);
+
+        __m128 x1 = _mm_sub_ps(x, onef);
+        __m128 y1 = _mm_sub_ps(y, onef);
+        __m128 z1 = _mm_sub_ps(z, onef);
+
+        __m128 x11 = Lerp(u, Grad(h[0], x, y, z), Grad(h[1], x1, y, z));
+        __m128 x12 = Lerp(u, Grad(h[2], x, y1, z), Grad(h[3], x1, y1, z));
+        __m128 x21 = Lerp(u, Grad(h[4], x, y, z1), Grad(h[5], x1, y, z1));
+        __m128 x22 = Lerp(u, Grad(h[6], x, y1, z1), Grad(h[7], x1, y1, z1));
+
+        _mm_storeu_ps(out + i, Lerp(w, Lerp(v, x11, x12), Lerp(v, x21, x22)));
+    }
+
+    return i;
+}
+
+} // namespace
+
+namespace NoiseKernels {
+
+size_t BatchSSE4(const int* perm, const float* xs, const float* ys, const float* zs, float* out,
+                 size_t n)
+{
+    PermutationCorners corners = { perm };
+    return Batch(corners, xs, ys, zs, out, n);
+}
+
+size_t BatchHashSSE4(uint32_t seed, const float* xs, const float* ys, const float* zs,
+                     float* out, size_t n)
+{
+    HashCorners corners = { _mm_set1_epi32(static_cast<int>(seed * HASH_PRIME_SEED)) };
+    return Batch(corners, xs, ys, zs, out, n);
+}
+
+} // namespace NoiseKernels
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Noise Tile Cache definitions.
+ */
+
+#include "NoiseTileCache.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+// SplitMix64 finalizer - spreads neighbouring coordinates evenly over shards and buckets
+uint64_t MixBits(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+// 64-bit hash of @p key, even where size_t is narrower. Shards and buckets use its halves.
+uint64_t HashKey(const NoiseTileKey& key)
+{
+    uint64_t coords = (static_cast<uint64_t>(static_cast<uint32_t>(key.x)) << 32) |
+                      static_cast<uint32_t>(key.z);
+    uint64_t extra = (static_cast<uint64_t>(key.seed) << 8) | static_cast<uint64_t>(key.layer);
+    return MixBits(coords ^ MixBits(extra));
+}
+
+} // namespace
+
+
+bool NoiseTileKey::operator==(const NoiseTileKey& other) const noexcept
+{
+    return x == other.x && z == other.z && seed == other.seed && layer == other.layer;
+}
+
+size_t NoiseTileCache::KeyHash::operator()(const NoiseTileKey& key) const noexcept
+{
+    // Low half only, top one picks the shard
+    return static_cast<size_t>(static_cast<uint32_t>(HashKey(key)));
+}
+
+NoiseTileCache::NoiseTileCache(size_t capacity)
+    : mShardCapacity(std::max<size_t>(1, (capacity + SHARD_COUNT - 1) / SHARD_COUNT))
+    , mHits(0)
+    , mMisses(0)
+{
+}
+
+NoiseTileCache::Shard& NoiseTileCache::GetShard(const NoiseTileKey& key) noexcept
+{
+    // Top bits pick the shard, so they do not correlate with buckets inside shard's map
+    return mShards[(HashKey(key) >> 32) % SHARD_COUNT];
+}
+
+bool NoiseTileCache::Get(const NoiseTileKey& key, float* out, size_t size) noexcept
+{
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end() || it->second->values.size() != size)
+    {
+        mMisses++;
+        return false;
+    }
+
+    // Move entry to the front of LRU list
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    std::copy(it->second->values.begin(), it->second->values.end(), out);
+    mHits++;
+    return true;
+}
+
+void NoiseTileCache::Put(const NoiseTileKey& key, const float* tile, size_t size)
+{
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+        // Tile might have been generated by two threads at once - just refresh it
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        it->second->values.assign(tile, tile + size);
+        return;
+    }
+
+    if (shard.entries.size() >= mShardCapacity)
+    {
+        // Reuse least recently used entry, along with its buffer
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.splice(shard.entries.begin(), shard.entries, std::prev(shard.entries.end()));
+    }
+    else
+    {
+        shard.entries.emplace_front();
+    }
+
+    Entry& entry = shard.entries.front();
+    entry.key = key;
+    entry.values.assign(tile, tile + size);
+    shard.index[key] = shard.entries.begin();
+}
+
+void NoiseTileCache::Clear()
+{
+    for (auto& shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+    }
+
+    mHits = 0;
+    mMisses = 0;
+}
+
+size_t NoiseTileCache::GetSize() const
+{
+    size_t size = 0;
+    for (const auto& shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size += shard.entries.size();
+    }
+
+    return size;
+}
+
+uint64_t NoiseTileCache::GetHitCount() const noexcept
+{
+    return mHits;
+}
+
+uint64_t NoiseTileCache::GetMissCount() const noexcept
+{
+    return mMisses;
+}
+
+double NoiseTileCache::GetHitRate() const noexcept
+{
+    uint64_t hits = mHits;
+    uint64_t total = hits + mMisses;
+    if (total == 0)
+        return 0.0;
+
+    return static_cast<double>(hits) / static_cast<double>(total);
+}
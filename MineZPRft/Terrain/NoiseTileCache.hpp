@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Noise Tile Cache declaration.
+ */
+
+#ifndef __TERRAIN_NOISETILECACHE_HPP__
+#define __TERRAIN_NOISETILECACHE_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Default amount of tiles kept by NoiseTileCache.
+ */
+#define NOISE_TILE_CACHE_CAPACITY 1024
+
+/**
+ * Kinds of 2D noise tiles generated per chunk.
+ */
+enum class NoiseTileLayer: unsigned char
+{
+    Heightmap = 0,
+};
+
+/**
+ * Identifies a single tile in NoiseTileCache.
+ */
+struct NoiseTileKey
+{
+    int x;                  ///< Chunk's X coordinate.
+    int z;                  ///< Chunk's Z coordinate.
+    uint32_t seed;          ///< Seed of noise used to generate the tile.
+    NoiseTileLayer layer;   ///< What the tile contains.
+
+    bool operator==(const NoiseTileKey& other) const noexcept;
+};
+
+/**
+ * Thread-safe LRU cache of per-chunk 2D noise tiles.
+ *
+ * Generating 2D noise (heightmaps etc.) is repeated each time a chunk is regenerated, or when a
+ * chunk needs data of its neighbours. Cache keeps recently used tiles, so they can be copied
+ * instead of being generated again.
+ *
+ * Entries are distributed between several independently locked shards, so generator threads
+ * rarely wait for each other. Each shard evicts its least recently used tile when full.
+ */
+class NoiseTileCache
+{
+public:
+    /**
+     * @param capacity Maximum amount of tiles kept in cache.
+     */
+    explicit NoiseTileCache(size_t capacity = NOISE_TILE_CACHE_CAPACITY);
+
+    /**
+     * Copy tile described by @p key to @p out.
+     *
+     * @param key  Tile to look for.
+     * @param out  Output array of @p size values.
+     * @param size Amount of values in tile.
+     * @return True on cache hit. False if tile is not cached, @p out is left untouched then.
+     */
+    bool Get(const NoiseTileKey& key, float* out, size_t size) noexcept;
+
+    /**
+     * Store a copy of @p tile in cache, evicting least recently used tile if needed.
+     *
+     * @param key  Tile identifier.
+     * @param tile Array of @p size values.
+     * @param size Amount of values in tile.
+     */
+    void Put(const NoiseTileKey& key, const float* tile, size_t size);
+
+    /**
+     * Remove all tiles from cache and reset counters.
+     */
+    void Clear();
+
+    /**
+     * Acquire amount of tiles currently kept in cache.
+     */
+    size_t GetSize() const;
+
+    /**
+     * Acquire amount of Get() calls which found their tile.
+     */
+    uint64_t GetHitCount() const noexcept;
+
+    /**
+     * Acquire amount of Get() calls which did not find their tile.
+     */
+    uint64_t GetMissCount() const noexcept;
+
+    /**
+     * Acquire ratio of hits to all Get() calls, in 0..1 range.
+     */
+    double GetHitRate() const noexcept;
+
+private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct Entry
+    {
+        NoiseTileKey key;
+        std::vector<float> values;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const NoiseTileKey& key) const noexcept;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        EntryList entries;  // most recently used first
+        std::unordered_map<NoiseTileKey, EntryList::iterator, KeyHash> index;
+    };
+
+    Shard& GetShard(const NoiseTileKey& key) noexcept;
+
+    Shard mShards[SHARD_COUNT];
+    size_t mShardCapacity;
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+};
+
+#endif // __TERRAIN_NOISETILECACHE_HPP__
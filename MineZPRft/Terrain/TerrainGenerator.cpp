@@ -0,0 +1,449 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain Generator definitions.
+ */
+
+#include "TerrainGenerator.hpp"
+
+#include "NoiseGenerator.hpp"
+#include "NoiseKernels.hpp"
+#include "VoxelFill.hpp"
+#include "Common/Logger.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+
+const float AIR_THRESHOLD = 0.3f;
+
+// Cave noise is sampled every CAVE_STEP voxels and interpolated in between. Lattice is aligned to
+// world coordinates, so neighbouring chunks share their border samples and caves stay seamless.
+const int CAVE_STEP = 4;
+const double CAVE_SCALE = 0.1;
+const int CAVE_LATTICE_X = CHUNK_X / CAVE_STEP + 1;
+const int CAVE_LATTICE_Y = CHUNK_Y / CAVE_STEP + 1;
+const int CAVE_LATTICE_Z = CHUNK_Z / CAVE_STEP + 1;
+const int CAVE_LATTICE_MAX = CAVE_LATTICE_X * CAVE_LATTICE_Y * CAVE_LATTICE_Z;
+
+// Climate noise frequency, per column. Lattice is aligned to world coordinates, just like caves.
+const double CLIMATE_FREQUENCY = 1.0 / 256.0;
+const int CLIMATE_LATTICE_X = CHUNK_X / CLIMATE_STEP + 1;
+const int CLIMATE_LATTICE_Z = CHUNK_Z / CLIMATE_STEP + 1;
+
+// Climate is taken from a plane of 3D noise far above caves. Humidity is taken from the same plane
+// as temperature, but far away from it.
+const double CLIMATE_PLANE_Y = 1000.5;
+const double HUMIDITY_OFFSET = 1000.5;
+
+// Amount of subsurface voxels below surface voxel of a biome
+const int SUBSURFACE_DEPTH = 3;
+
+// Highest column top, leaving at least one layer of air above terrain
+const int MAX_COLUMN_TOP = CHUNK_Y - 1;
+
+// Trees - at most one per TREE_CELL x TREE_CELL columns, in TREE_CHANCE percent of cells. Cells
+// are aligned to world coordinates. Crown reaches DECORATION_REACH columns from the trunk.
+const int TREE_CELL = 8;
+const uint32_t TREE_CHANCE = 40;
+const int TREE_MIN_TRUNK = 4;
+const int TREE_MAX_TRUNK = 6;
+const int TREE_CROWN_BOTTOM = -2;
+const int TREE_CROWN_TOP = 1;
+
+// MurmurHash3 finalizer over world coordinates of a tree cell, mixed with world's seed
+uint32_t CellHash(uint32_t seed, int cellX, int cellZ)
+{
+    uint32_t h = static_cast<uint32_t>(cellX) * NoiseKernels::HASH_PRIME_X ^
+                 static_cast<uint32_t>(cellZ) * NoiseKernels::HASH_PRIME_Z ^
+                 seed * NoiseKernels::HASH_PRIME_SEED;
+    h ^= h >> 16;
+    h *= NoiseKernels::HASH_MIX_1;
+    h ^= h >> 13;
+    h *= NoiseKernels::HASH_MIX_2;
+    h ^= h >> 16;
+    return h;
+}
+
+bool IsDecoration(VoxelType voxel)
+{
+    return voxel == VoxelType::Wood || voxel == VoxelType::Leaves;
+}
+
+// Round towards negative infinity, so negative voxel coordinates map to the previous chunk
+int FloorDiv(int a, int b)
+{
+    return (a >= 0) ? (a / b) : ((a - b + 1) / b);
+}
+
+float Lerp(float t, float a, float b)
+{
+    return a + t * (b - a);
+}
+
+// Bilinearly interpolate climate lattice (sample [lx, lz] stored at lz * CLIMATE_LATTICE_X + lx)
+// to all columns of a chunk. Interpolation is split into a pass along Z and a pass along X, so
+// the inner loops run over contiguous arrays.
+void InterpolateClimate(const float* samples, float* out)
+{
+    float lines[CLIMATE_LATTICE_X][CHUNK_Z];
+    for (int lx = 0; lx < CLIMATE_LATTICE_X; ++lx)
+        for (int lz = 0; lz < CLIMATE_LATTICE_Z - 1; ++lz)
+        {
+            float a = samples[lz * CLIMATE_LATTICE_X + lx];
+            float b = samples[(lz + 1) * CLIMATE_LATTICE_X + lx];
+            for (int i = 0; i < CLIMATE_STEP; ++i)
+                lines[lx][lz * CLIMATE_STEP + i] = Lerp(static_cast<float>(i) / CLIMATE_STEP, a, b);
+        }
+
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        const float* a = lines[x / CLIMATE_STEP];
+        const float* b = lines[x / CLIMATE_STEP + 1];
+        float t = static_cast<float>(x % CLIMATE_STEP) / CLIMATE_STEP;
+
+        float* column = out + x * CHUNK_Z;
+        for (int z = 0; z < CHUNK_Z; ++z)
+            column[z] = Lerp(t, a[z], b[z]);
+    }
+}
+
+size_t VoxelIndex(int x, int y, int z)
+{
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+} // namespace
+
+
+TerrainGeneratorDesc::TerrainGeneratorDesc()
+    : seed(0)
+    , noiseBackend(NoiseBackend::Permutation)
+    , caves(false)
+    , biomes(false)
+    , decorations(false)
+{
+}
+
+
+TerrainGeneratorDesc GetWorldGeneratorDesc(uint32_t seed)
+{
+    TerrainGeneratorDesc desc;
+    desc.seed = seed;
+    desc.noiseBackend = NoiseBackend::Permutation;
+    desc.heightmap.type = FractalType::FBM;
+    desc.heightmap.octaves = 4;
+    desc.heightmap.frequency = 1.0 / 64.0;
+    desc.heightmap.lacunarity = 2.0;
+    desc.heightmap.gain = 0.5;
+    desc.caves = true;
+    desc.biomes = true;
+    desc.decorations = true;
+    return desc;
+}
+
+
+TerrainGenerator::TerrainGenerator()
+    : mCaves(false)
+    , mBiomes(false)
+    , mDecorations(false)
+{
+}
+
+TerrainGenerator::~TerrainGenerator()
+{
+}
+
+void TerrainGenerator::Init(const TerrainGeneratorDesc& desc)
+{
+    mNoise = NoiseGenerator(desc.seed, desc.noiseBackend);
+    mHeightmapNoise = FractalNoise(desc.heightmap);
+    mCaves = desc.caves;
+    mBiomes = desc.biomes;
+    mDecorations = desc.decorations;
+
+    // Tiles generated with previous parameters are no longer valid
+    mNoiseTileCache.Clear();
+}
+
+void TerrainGenerator::Generate(VoxelType* voxels, int coordX, int coordZ) const noexcept
+{
+    // Stage 1 - generate a heightmap using 2D fractal noise, for all columns at once
+    float heightMap[CHUNK_X * CHUNK_Z];
+    GetHeightmapNoise(coordX, coordZ, heightMap);
+
+    // Climate of each column, used to pick biomes
+    ChunkClimate climate;
+    if (mBiomes)
+        GetClimate(coordX, coordZ, climate);
+
+    // Convert heightmap to column tops. Stone base fills bottom quarter of the chunk, the heightmap
+    // adds up to HEIGHTMAP_HEIGHT voxels on top of it. Biomes can scale and raise it further.
+    int columnTop[CHUNK_X * CHUNK_Z];
+    for (int i = 0; i < CHUNK_X * CHUNK_Z; ++i)
+    {
+        // Noise-returned values span -1..1 range, convert them to 0..HEIGHTMAP_HEIGHT range.
+        float height = (heightMap[i] + 1.0f) * (HEIGHTMAP_HEIGHT / 2);
+        int maxStoneCount = HEIGHTMAP_HEIGHT;
+        if (mBiomes)
+        {
+            height = height * climate.heightScale[i] + climate.heightOffset[i];
+            maxStoneCount = MAX_COLUMN_TOP - CHUNK_Y / 4;
+        }
+
+        // Heightmap voxel at level k is stone if height >= k
+        int stoneCount = height < 0.0f ? 0 : static_cast<int>(height) + 1;
+        if (stoneCount > maxStoneCount)
+            stoneCount = maxStoneCount;
+        columnTop[i] = CHUNK_Y / 4 + stoneCount;
+    }
+
+    LOG_D("  Chunk [" << coordX << ", " << coordZ << "] Stage 1 done");
+
+    // Stage 2 - fill columns with bedrock (bottom two layers), stone up to column's top and air
+    // above. X slices are contiguous in memory, so the whole chunk is written in a single pass,
+    // slice by slice. Only layers between the lowest and the highest top of a slice differ
+    // between columns, the rest are written with bulk fills.
+    int maxY = 0;
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        // NOTE heightmap is indexed as [x][z], see GetHeightmapNoise().
+        const int* sliceTop = columnTop + x * CHUNK_Z;
+        int sliceMinTop = CHUNK_Y;
+        int sliceMaxTop = 0;
+        for (int z = 0; z < CHUNK_Z; ++z)
+        {
+            sliceMinTop = std::min(sliceMinTop, sliceTop[z]);
+            sliceMaxTop = std::max(sliceMaxTop, sliceTop[z]);
+        }
+
+        FillBox(voxels, x, 0, 0, x + 1, 2, CHUNK_Z, VoxelType::Bedrock);
+        FillBox(voxels, x, 2, 0, x + 1, sliceMinTop, CHUNK_Z, VoxelType::Stone);
+
+        for (int y = sliceMinTop; y < sliceMaxTop; ++y)
+        {
+            VoxelType* row = voxels + VoxelIndex(x, y, 0);
+            for (int z = 0; z < CHUNK_Z; ++z)
+                row[z] = (y < sliceTop[z]) ? VoxelType::Stone : VoxelType::Air;
+        }
+
+        FillBox(voxels, x, sliceMaxTop, 0, x + 1, CHUNK_Y, CHUNK_Z, VoxelType::Air);
+        maxY = std::max(maxY, sliceMaxTop);
+    }
+
+    // Cover stone with biome's surface voxels
+    if (mBiomes)
+    {
+        for (int x = 0; x < CHUNK_X; ++x)
+            for (int z = 0; z < CHUNK_Z; ++z)
+            {
+                int i = x * CHUNK_Z + z;
+                const BiomeDesc& biome = GetBiomeDesc(SelectBiome(climate.temperature[i],
+                                                                  climate.humidity[i]));
+                int top = columnTop[i];
+                FillColumn(voxels, x, z, top - 1 - SUBSURFACE_DEPTH, top - 1, biome.subsurface);
+                voxels[VoxelIndex(x, top - 1, z)] = biome.surface;
+            }
+    }
+
+    LOG_D("  Chunk [" << coordX << ", " << coordZ << "] Stage 2 done");
+
+    // Stage 3 - cut through the terrain with some Perlin-generated caves
+    if (mCaves)
+    {
+        CarveCaves(voxels, coordX, coordZ, maxY);
+        LOG_D("  Chunk [" << coordX << ", " << coordZ << "] Stage 3 done");
+    }
+}
+
+void TerrainGenerator::Decorate(const VoxelType* voxels, int coordX, int coordZ,
+                                std::vector<DecorationWrite>& writes) const noexcept
+{
+    if (!mDecorations)
+        return;
+
+    // Voxel coordinates are relative to decorated chunk and may exceed its borders
+    auto emit = [&](int x, int y, int z, VoxelType voxel)
+    {
+        int chunkOffsetX = FloorDiv(x, CHUNK_X);
+        int chunkOffsetZ = FloorDiv(z, CHUNK_Z);
+        DecorationWrite write;
+        write.chunkX = coordX + chunkOffsetX;
+        write.chunkZ = coordZ + chunkOffsetZ;
+        write.index = static_cast<uint32_t>(VoxelIndex(x - chunkOffsetX * CHUNK_X, y,
+                                                       z - chunkOffsetZ * CHUNK_Z));
+        write.voxel = voxel;
+        writes.push_back(write);
+    };
+
+    const int cellsX = CHUNK_X / TREE_CELL;
+    const int cellsZ = CHUNK_Z / TREE_CELL;
+    for (int cellX = 0; cellX < cellsX; ++cellX)
+        for (int cellZ = 0; cellZ < cellsZ; ++cellZ)
+        {
+            uint32_t hash = CellHash(mNoise.GetSeed(), coordX * cellsX + cellX,
+                                     coordZ * cellsZ + cellZ);
+            if (hash % 100 >= TREE_CHANCE)
+                continue;
+
+            int x = cellX * TREE_CELL + static_cast<int>((hash >> 8) % TREE_CELL);
+            int z = cellZ * TREE_CELL + static_cast<int>((hash >> 12) % TREE_CELL);
+            int trunk = TREE_MIN_TRUNK +
+                        static_cast<int>((hash >> 16) % (TREE_MAX_TRUNK - TREE_MIN_TRUNK + 1));
+
+            // Find the ground, skipping whatever neighbours' decorations placed above it
+            int ground = CHUNK_Y - 1;
+            while (ground > 0 && (voxels[VoxelIndex(x, ground, z)] == VoxelType::Air ||
+                                  IsDecoration(voxels[VoxelIndex(x, ground, z)])))
+                ground--;
+
+            int top = ground + trunk;
+            if (voxels[VoxelIndex(x, ground, z)] != VoxelType::Grass ||
+                top + TREE_CROWN_TOP >= CHUNK_Y)
+                continue;
+
+            for (int y = ground + 1; y < top; ++y)
+                emit(x, y, z, VoxelType::Wood);
+
+            // Crown is a rounded box, wide at the bottom and narrow at the top
+            for (int dy = TREE_CROWN_BOTTOM; dy <= TREE_CROWN_TOP; ++dy)
+            {
+                int radius = (dy < 0) ? DECORATION_REACH : DECORATION_REACH - 1;
+                for (int dx = -radius; dx <= radius; ++dx)
+                    for (int dz = -radius; dz <= radius; ++dz)
+                    {
+                        bool corner = (dx == -radius || dx == radius) &&
+                                      (dz == -radius || dz == radius);
+                        if (corner && (dy == TREE_CROWN_BOTTOM || dy == TREE_CROWN_TOP))
+                            continue;
+
+                        emit(x + dx, top + dy, z + dz, VoxelType::Leaves);
+                    }
+            }
+        }
+}
+
+void TerrainGenerator::GetHeightmapNoise(int coordX, int coordZ, float* out) const noexcept
+{
+    NoiseTileKey key = { coordX, coordZ, mNoise.GetSeed(), NoiseTileLayer::Heightmap };
+
+    if (mNoiseTileCache.Get(key, out, CHUNK_X * CHUNK_Z))
+        return;
+
+    // Noise origin is shifted according to chunk coordinates.
+    // This way the map will be seamless and the chunks connected.
+    mHeightmapNoise.GenerateTile(mNoise, CHUNK_Z * coordZ, CHUNK_X * coordX,
+                                 CHUNK_X, CHUNK_Z, out);
+    mNoiseTileCache.Put(key, out, CHUNK_X * CHUNK_Z);
+}
+
+void TerrainGenerator::GetClimate(int coordX, int coordZ, ChunkClimate& climate) const noexcept
+{
+    // Lattice points on chunk borders are shared with neighbours, so climate stays seamless.
+    // Sample [lx, lz] is stored at lz * CLIMATE_LATTICE_X + lx, humidity follows temperature.
+    const int sampleCount = CLIMATE_LATTICE_X * CLIMATE_LATTICE_Z;
+    float xs[2 * sampleCount];
+    float ys[2 * sampleCount];
+    float zs[2 * sampleCount];
+    float samples[2 * sampleCount];
+    for (int lz = 0; lz < CLIMATE_LATTICE_Z; ++lz)
+        for (int lx = 0; lx < CLIMATE_LATTICE_X; ++lx)
+        {
+            int i = lz * CLIMATE_LATTICE_X + lx;
+            double x = (lx * CLIMATE_STEP + CHUNK_X * coordX) * CLIMATE_FREQUENCY;
+            double z = (lz * CLIMATE_STEP + CHUNK_Z * coordZ) * CLIMATE_FREQUENCY;
+            xs[i] = static_cast<float>(x);
+            zs[i] = static_cast<float>(z);
+            xs[i + sampleCount] = static_cast<float>(x + HUMIDITY_OFFSET);
+            zs[i + sampleCount] = static_cast<float>(z + HUMIDITY_OFFSET);
+        }
+    std::fill(ys, ys + 2 * sampleCount, static_cast<float>(CLIMATE_PLANE_Y));
+
+    // Both fields are sampled at once, to make the most of SIMD kernels
+    mNoise.NoiseBatch(xs, ys, zs, samples, 2 * sampleCount);
+    const float* temperature = samples;
+    const float* humidity = samples + sampleCount;
+
+    // Height profiles are smooth, so they can be interpolated just like climate itself
+    float heightScale[sampleCount];
+    float heightOffset[sampleCount];
+    BlendHeightProfiles(temperature, humidity, heightScale, heightOffset, sampleCount);
+
+    InterpolateClimate(temperature, climate.temperature);
+    InterpolateClimate(humidity, climate.humidity);
+    InterpolateClimate(heightScale, climate.heightScale);
+    InterpolateClimate(heightOffset, climate.heightOffset);
+}
+
+const NoiseTileCache& TerrainGenerator::GetNoiseTileCache() const noexcept
+{
+    return mNoiseTileCache;
+}
+
+void TerrainGenerator::CarveCaves(VoxelType* voxels, int coordX, int coordZ,
+                                  int maxY) const noexcept
+{
+    // Only the occupied Y range (above bedrock, below the highest stone voxel) is sampled
+    const int minY = 2;
+    if (maxY <= minY)
+        return;
+
+    int latticeMinY = minY / CAVE_STEP;
+    // Upper sample of the highest voxel's cell is needed too, even if voxel lies on the lattice
+    int latticeMaxY = (maxY - 1) / CAVE_STEP + 1;
+    int latticeY = latticeMaxY - latticeMinY + 1;
+
+    float xs[CAVE_LATTICE_MAX];
+    float ys[CAVE_LATTICE_MAX];
+    float zs[CAVE_LATTICE_MAX];
+    float samples[CAVE_LATTICE_MAX];
+
+    size_t count = 0;
+    for (int lx = 0; lx < CAVE_LATTICE_X; ++lx)
+        for (int ly = latticeMinY; ly <= latticeMaxY; ++ly)
+            for (int lz = 0; lz < CAVE_LATTICE_Z; ++lz, ++count)
+            {
+                xs[count] = static_cast<float>((lx * CAVE_STEP + CHUNK_X * coordX) * CAVE_SCALE);
+                ys[count] = static_cast<float>(ly * CAVE_STEP * CAVE_SCALE);
+                zs[count] = static_cast<float>((lz * CAVE_STEP + CHUNK_Z * coordZ) * CAVE_SCALE);
+            }
+
+    mNoise.NoiseBatch(xs, ys, zs, samples, count);
+
+    auto sample = [&](int lx, int ly, int lz)
+    {
+        return samples[(lx * latticeY + ly) * CAVE_LATTICE_Z + lz];
+    };
+
+    // Interpolate on XZ plane once per column and lattice layer, then along Y per voxel
+    float column[CAVE_LATTICE_Y];
+    for (int x = 0; x < CHUNK_X; ++x)
+    {
+        int lx = x / CAVE_STEP;
+        float tx = static_cast<float>(x % CAVE_STEP) / CAVE_STEP;
+
+        for (int z = 0; z < CHUNK_Z; ++z)
+        {
+            int lz = z / CAVE_STEP;
+            float tz = static_cast<float>(z % CAVE_STEP) / CAVE_STEP;
+
+            for (int ly = 0; ly < latticeY; ++ly)
+                column[ly] = Lerp(tx, Lerp(tz, sample(lx, ly, lz), sample(lx, ly, lz + 1)),
+                                  Lerp(tz, sample(lx + 1, ly, lz), sample(lx + 1, ly, lz + 1)));
+
+            for (int y = minY; y < maxY; ++y)
+            {
+                VoxelType& voxel = voxels[VoxelIndex(x, y, z)];
+                if (voxel == VoxelType::Air)
+                    continue;
+
+                int ly = y / CAVE_STEP - latticeMinY;
+                float ty = static_cast<float>(y % CAVE_STEP) / CAVE_STEP;
+                if (Lerp(ty, column[ly], column[ly + 1]) > AIR_THRESHOLD)
+                    voxel = VoxelType::Air;
+            }
+        }
+    }
+}
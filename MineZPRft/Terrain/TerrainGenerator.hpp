@@ -0,0 +1,165 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain Generator declaration.
+ */
+
+#ifndef __TERRAIN_TERRAINGENERATOR_HPP__
+#define __TERRAIN_TERRAINGENERATOR_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+#include "Biome.hpp"
+#include "Decoration.hpp"
+#include "NoiseGenerator.hpp"
+#include "FractalNoise.hpp"
+#include "NoiseTileCache.hpp"
+
+/**
+ * Distance in columns between climate samples, see TerrainGenerator::GetClimate().
+ */
+#define CLIMATE_STEP 4
+
+/**
+ * Farthest distance in columns, to which a decoration can reach from its root column.
+ */
+#define DECORATION_REACH 2
+
+/**
+ * Climate of all columns of a chunk. Value of column [x, z] is stored at x * CHUNK_Z + z.
+ */
+struct ChunkClimate
+{
+    float temperature[CHUNK_X * CHUNK_Z];   ///< Temperature in -1..1 range.
+    float humidity[CHUNK_X * CHUNK_Z];      ///< Humidity in -1..1 range.
+    float heightScale[CHUNK_X * CHUNK_Z];   ///< Blended BiomeDesc::heightScale.
+    float heightOffset[CHUNK_X * CHUNK_Z];  ///< Blended BiomeDesc::heightOffset.
+};
+
+/**
+ * Parameters of terrain generation, set per world.
+ */
+struct TerrainGeneratorDesc
+{
+    uint32_t seed;              ///< Seed of world's noise. 0 selects reference noise.
+    NoiseBackend noiseBackend;  ///< Source of noise gradients.
+    FractalDesc heightmap;      ///< Noise shaping the surface of terrain.
+    bool caves;                 ///< Cut caves through the terrain.
+    bool biomes;                ///< Shape and cover terrain according to climate.
+    bool decorations;           ///< Grow trees on grass, see TerrainGenerator::Decorate().
+
+    /**
+     * Defaults to reference permutation noise, single octave heightmap without caves, biomes and
+     * decorations.
+     */
+    TerrainGeneratorDesc();
+};
+
+/**
+ * Acquire parameters of terrain generation used by the game world with @p seed.
+ *
+ * Chunks generated outside of the game (ex. by MineZPRftPregen) must use the same parameters,
+ * otherwise they would not connect seamlessly with chunks generated in game.
+ */
+TerrainGeneratorDesc GetWorldGeneratorDesc(uint32_t seed);
+
+/**
+ * Fills voxel arrays with procedurally generated terrain.
+ *
+ * Generator works only on raw voxel data and has no dependency on Renderer, so it can be used
+ * without an OpenGL context (ex. in benchmarks and tests). Voxel arrays are laid out the same way
+ * as Chunk's internal array - index = x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z.
+ */
+class TerrainGenerator
+{
+public:
+    TerrainGenerator();
+    ~TerrainGenerator();
+
+    /**
+     * Set parameters of generated terrain.
+     *
+     * @param desc Parameters of terrain generation.
+     *
+     * @remarks Must not be called while any Generate() call is in progress.
+     */
+    void Init(const TerrainGeneratorDesc& desc);
+
+    /**
+     * Fills @p voxels with Perlin-generated terrain.
+     *
+     * @param voxels Array of CHUNK_VOXEL_COUNT voxels to fill.
+     * @param coordX Chunk's X coordinate in the world.
+     * @param coordZ Chunk's Z coordinate in the world.
+     *
+     * The chunks in the world create a two-dimensional grid. All are connected and it is assumed,
+     * that the map generated in between them is seamless.
+     */
+    void Generate(VoxelType* voxels, int coordX, int coordZ) const noexcept;
+
+    /**
+     * Place decorations (trees) rooted in a generated chunk.
+     *
+     * @param voxels Array of CHUNK_VOXEL_COUNT voxels, filled by Generate().
+     * @param coordX Chunk's X coordinate in the world.
+     * @param coordZ Chunk's Z coordinate in the world.
+     * @param writes Output writes, appended to the vector.
+     *
+     * Decorations are rooted in @p voxels, but can reach up to DECORATION_REACH voxels into
+     * neighbouring chunks. They are not placed directly, but returned as writes, which should be
+     * routed through DecorationQueue. Roots are picked by hashing world coordinates and ground is
+     * found skipping decoration voxels, so the result does not depend on whether neighbours have
+     * already placed their decorations over @p voxels.
+     */
+    void Decorate(const VoxelType* voxels, int coordX, int coordZ,
+                  std::vector<DecorationWrite>& writes) const noexcept;
+
+    /**
+     * Acquire heightmap noise of a chunk.
+     *
+     * @param coordX Chunk's X coordinate in the world.
+     * @param coordZ Chunk's Z coordinate in the world.
+     * @param out    Output array of CHUNK_X * CHUNK_Z noise values in -1..1 range. Value of
+     *               column [x, z] is stored at x * CHUNK_Z + z.
+     *
+     * Heightmaps are kept in a cache, so calling this for neighbouring chunks during generation
+     * is cheap.
+     */
+    void GetHeightmapNoise(int coordX, int coordZ, float* out) const noexcept;
+
+    /**
+     * Acquire climate of a chunk.
+     *
+     * @param coordX  Chunk's X coordinate in the world.
+     * @param coordZ  Chunk's Z coordinate in the world.
+     * @param climate Output climate of all columns.
+     *
+     * Climate changes slowly, so noise and biome height profiles are evaluated only once per
+     * CLIMATE_STEP x CLIMATE_STEP columns, on a lattice aligned to world coordinates, and
+     * bilinearly interpolated for columns in between.
+     */
+    void GetClimate(int coordX, int coordZ, ChunkClimate& climate) const noexcept;
+
+    /**
+     * Acquire cache of noise tiles, ex. to check its hit rate.
+     */
+    const NoiseTileCache& GetNoiseTileCache() const noexcept;
+
+private:
+    /**
+     * Carve caves in stone below @p maxY.
+     *
+     * 3D noise is evaluated only on a coarse lattice (every 4 voxels) covering the
+     * occupied part of the chunk and trilinearly interpolated for voxels in between.
+     */
+    void CarveCaves(VoxelType* voxels, int coordX, int coordZ, int maxY) const noexcept;
+
+    NoiseGenerator mNoise;
+    FractalNoise mHeightmapNoise;
+    bool mCaves;
+    bool mBiomes;
+    bool mDecorations;
+    mutable NoiseTileCache mNoiseTileCache;
+};
+
+#endif // __TERRAIN_TERRAINGENERATOR_HPP__
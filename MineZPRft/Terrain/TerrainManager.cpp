@@ -12,13 +12,63 @@
 #include "Common/Logger.hpp"
 #include "Renderer/Renderer.hpp"
 
+#include <algorithm>
 #include <functional>
+#include <initializer_list>
+#include <map>
 #include <thread>
 
+namespace
+{
+
+// Chunks up to this far (in both axes) from a visible chunk are generated
+const int REGION_MARGIN = 2;
+
+// Chunks past the radius of a level of detail, which switch to it only this much further
+const unsigned int LOD_HYSTERESIS = 1;
+
+const int NEIGHBOUR_OFFSETS[8][2] = {
+    {-1, -1}, {-1, 0}, {-1, 1},
+    { 0, -1},          { 0, 1},
+    { 1, -1}, { 1, 0}, { 1, 1},
+};
+
+// Indices of NEIGHBOUR_OFFSETS, which share a side with the chunk
+const int NEIGHBOUR_X_PLUS = 6;
+const int NEIGHBOUR_X_MINUS = 1;
+const int NEIGHBOUR_Z_PLUS = 4;
+const int NEIGHBOUR_Z_MINUS = 3;
+
+// Neighbours of @p slot bordering it with a side, used when meshing the slot's chunk
+ChunkNeighbours GetSideNeighbours(const TerrainSlot& slot) noexcept
+{
+    ChunkNeighbours neighbours;
+    neighbours.xPlus = slot.neighbours[NEIGHBOUR_X_PLUS];
+    neighbours.xMinus = slot.neighbours[NEIGHBOUR_X_MINUS];
+    neighbours.zPlus = slot.neighbours[NEIGHBOUR_Z_PLUS];
+    neighbours.zMinus = slot.neighbours[NEIGHBOUR_Z_MINUS];
+    return neighbours;
+}
+
+// Check if a task of any of @p neighbours has not finished yet
+bool AnyTaskReserved(const ChunkNeighbours& neighbours) noexcept
+{
+    for (const Chunk* neighbour : { neighbours.xPlus, neighbours.xMinus,
+                                    neighbours.zPlus, neighbours.zMinus })
+        if (neighbour && neighbour->IsTaskReserved())
+            return true;
+
+    return false;
+}
+
+} // namespace
+
 
 TerrainManager::TerrainManager()
     : mCurrentChunkX(0)
     , mCurrentChunkZ(0)
+    , mGeneratorThreads(0)
+    , mMaxGeneratorThreads(1)
 {
 }
 
@@ -39,7 +89,14 @@ void TerrainManager::Init(const TerrainDesc& desc)
     LOG_D("Chunk count: " << mChunkCount << " on radius " << desc.visibleRadius);
     mChunks.resize(mChunkCount);
     mVisibleRadius = desc.visibleRadius;
-    mUseGreedyMeshing = desc.useGreedyMeshing;
+    mMeshingMethod = desc.meshingMethod;
+    std::copy(desc.lodRadius, desc.lodRadius + ChunkMesher::LOD_LEVEL_COUNT - 1, mLodRadius);
+
+    // Find out which chunks can be loaded from disk
+    mChunkPool.Init(desc.chunkCompression);
+
+    mGenerator.Init(desc.generator);
+    mMaxGeneratorThreads = std::max(std::thread::hardware_concurrency(), 1u);
 
     LOG_I("Generating terrain...");
 
@@ -48,6 +105,7 @@ void TerrainManager::Init(const TerrainDesc& desc)
 
     // Generate chunks (this will push tasks to do for generator thread)
     GenerateChunks();
+    ScheduleTasks();
 
     LOG_I("Done generating terrain.");
 }
@@ -63,58 +121,94 @@ void TerrainManager::Update(int chunkX, int chunkZ, Vector pos, Vector dir,
         GenerateChunks();
     }
 
+    // Edit first, so its remesh is scheduled still in this frame
+    if (ray)
+        EditPickedVoxel(pos, dir);
+
+    ScheduleTasks();
+
     for (auto& chunk : mChunks)
     {
         if (chunk->IsGenerated())
-            chunk->CommitMeshUpdate();
-    }
-
-    // Use picking on center chunk and adjacent ones
-    if (ray)
-    {
-        // Final results
-        float rayDist = std::numeric_limits<float>::max();
-        Vector rayCoords;
-        Chunk* rayChunk = nullptr;
-
-        // Temporary results
-        float tempDist = std::numeric_limits<float>::max();
-        Vector tempCoords;
-
-        // For each out of 5 middle chunks calculate picking.
-        // Final result will be voxel with smallest distance from players eyes.
-        for (int i = 0; i < 4; ++i)
-            if (!mChunks[i]->NeedsGeneration())
-                if (mChunks[i]->ChunkRayIntersection(pos, dir, tempDist, tempCoords))
-                    if (tempDist < rayDist)
-                    {
-                        rayDist = tempDist;
-                        rayCoords = tempCoords;
-                        rayChunk = mChunks[i];
-                    }
-
-        // If any voxel was picked, turn it into Bedrock, so we can see it
-        if (rayChunk != nullptr)
         {
-            rayChunk->SetVoxel(static_cast<size_t>(rayCoords[0]),
-                               static_cast<size_t>(rayCoords[1]),
-                               static_cast<size_t>(rayCoords[2]),
-                               VoxelType::Bedrock);
-            if (mUseGreedyMeshing)
-                rayChunk->GenerateVBOGreedy();
-            else
-                rayChunk->GenerateVBONaive();
-
-             LOG_D("Ray intersection done. Chunk found!" << " Voxel["
-                   << rayCoords[0] << "," << rayCoords[1] << "," << rayCoords[2]
-                   << "]. Distance = " << rayDist << ".");
+            chunk->CommitMeshUpdate();
+            FinishEdits(chunk);
         }
     }
+
+    for (auto& edit : mRunningEdits)
+        edit.frames++;
+}
+
+void TerrainManager::EditPickedVoxel(const Vector& pos, const Vector& dir) noexcept
+{
+    Timer editTimer;
+    editTimer.Start();
+
+    // Final results
+    float rayDist = std::numeric_limits<float>::max();
+    Vector rayCoords;
+    Chunk* rayChunk = nullptr;
+
+    // Temporary results
+    float tempDist = std::numeric_limits<float>::max();
+    Vector tempCoords;
+
+    // For each out of 5 middle chunks calculate picking.
+    // Final result will be voxel with smallest distance from players eyes.
+    for (int i = 0; i < 4; ++i)
+        if (mChunks[i]->GetState() >= ChunkState::Generated)
+            if (mChunks[i]->ChunkRayIntersection(pos, dir, tempDist, tempCoords))
+                if (tempDist < rayDist)
+                {
+                    rayDist = tempDist;
+                    rayCoords = tempCoords;
+                    rayChunk = mChunks[i];
+                }
+
+    // If any voxel was picked, turn it into Bedrock, so we can see it
+    if (rayChunk == nullptr)
+        return;
+
+    // Voxel is changed later, when no task reads or writes it
+    VoxelEdit edit = { rayChunk->GetCoordX(), rayChunk->GetCoordZ(),
+                       static_cast<int>(rayCoords[0]), static_cast<int>(rayCoords[1]),
+                       static_cast<int>(rayCoords[2]), VoxelType::Bedrock, false, true, nullptr,
+                       0, editTimer };
+    mPendingEdits.push_back(edit);
+
+    LOG_D("Ray intersection done. Chunk found!" << " Voxel["
+          << rayCoords[0] << "," << rayCoords[1] << "," << rayCoords[2]
+          << "]. Distance = " << rayDist << ".");
+    LOG_I("Voxel edit took " << editTimer.Stop() * 1000.0 << " ms of the frame.");
 }
 
 void TerrainManager::GenerateChunks()
 {
-    // Add chunk generation to pool for separate thread.
+    // Region of chunks needed by visible ones, indexed by world coordinates
+    std::map<ChunkPool::ChunkKeyType, size_t> regionIndex;
+    mRegion.clear();
+
+    // Edited chunks might not be visible anymore, so their latency is not measured
+    mRunningEdits.clear();
+
+    auto addToRegion = [&](int coordX, int coordZ) -> TerrainSlot&
+    {
+        ChunkPool::ChunkKeyType key(coordX, coordZ);
+        auto indexIt = regionIndex.find(key);
+        if (indexIt != regionIndex.end())
+            return mRegion[indexIt->second];
+
+        TerrainSlot slot;
+        slot.chunk = mChunkPool.GetChunk(coordX, coordZ);
+        slot.coordX = coordX;
+        slot.coordZ = coordZ;
+        slot.visible = false;
+        regionIndex.emplace(key, mRegion.size());
+        mRegion.push_back(slot);
+        return mRegion.back();
+    };
+
     unsigned int chunkIndex = 0;
     for (unsigned int i = 0; i <= mVisibleRadius; ++i)
     {
@@ -131,21 +225,20 @@ void TerrainManager::GenerateChunks()
 
         for (unsigned int j = 0; j < chunksInRadius; ++j)
         {
-            // Get chunk pointer from pool
-            Chunk* chunk = mChunkPool.GetChunk(mCurrentChunkX + xChunk,
-                                               mCurrentChunkZ + zChunk);
+            int coordX = mCurrentChunkX + xChunk;
+            int coordZ = mCurrentChunkZ + zChunk;
+
+            TerrainSlot& slot = addToRegion(coordX, coordZ);
+            slot.visible = true;
+            Chunk* chunk = slot.chunk;
             mChunks[chunkIndex] = chunk;
 
-            // Generate the Chunk if needed
-            if (chunk->NeedsGeneration())
-            {
-                chunk->ResetState();
-                mGeneratorQueue.Push(std::bind(&Chunk::Generate, mChunks[chunkIndex],
-                                               xChunk, zChunk, mCurrentChunkX, mCurrentChunkZ,
-                                               mUseGreedyMeshing));
-            }
+            for (int dx = -REGION_MARGIN; dx <= REGION_MARGIN; ++dx)
+                for (int dz = -REGION_MARGIN; dz <= REGION_MARGIN; ++dz)
+                    addToRegion(coordX + dx, coordZ + dz);
 
             chunk->Shift(xChunk, zChunk);
+            chunk->SetLod(SelectLod(chunk, i));
 
             // Send our chunk to Renderer
             Renderer::GetInstance().ReplaceTerrainMesh(chunkIndex, chunk->GetMeshPtr());
@@ -155,16 +248,210 @@ void TerrainManager::GenerateChunks()
         }
     }
 
-    // create a detached thread which will do the tasks in parallel
-    if (!mGeneratorQueue.IsEmpty())
+    // Chunks on the edge of the region miss some neighbours - these will never be decorated
+    for (auto& slot : mRegion)
+        for (int n = 0; n < 8; ++n)
+        {
+            auto indexIt = regionIndex.find(ChunkPool::ChunkKeyType(
+                slot.coordX + NEIGHBOUR_OFFSETS[n][0], slot.coordZ + NEIGHBOUR_OFFSETS[n][1]));
+            slot.neighbours[n] = (indexIt == regionIndex.end()) ?
+                                 nullptr : mRegion[indexIt->second].chunk;
+        }
+
+    LOG_D("Terrain region: " << mRegion.size() << " chunks, " << mChunkCount << " visible");
+    LOG_D("Noise tile cache hit rate: "
+          << mGenerator.GetNoiseTileCache().GetHitRate() * 100.0 << "%");
+}
+
+void TerrainManager::ScheduleTasks()
+{
+    ScheduleEdits();
+
+    for (const auto& slot : mRegion)
     {
+        Chunk* chunk = slot.chunk;
+
+        // Cheap checks first - state of neighbours matters only for chunks which can advance
+        switch (chunk->GetState())
+        {
+        case ChunkState::NotGenerated:
+            if (chunk->ReserveTask(ChunkState::NotGenerated))
+                mGeneratorQueue.Push(std::bind(&Chunk::GenerateTerrain, chunk,
+                                               slot.coordX, slot.coordZ, std::cref(mGenerator),
+                                               std::cref(mChunkPool.GetManifest()),
+                                               std::ref(mDecorationQueue)));
+            break;
+        case ChunkState::TerrainGenerated:
+            if (NeighboursReached(slot, ChunkState::TerrainGenerated) &&
+                chunk->ReserveTask(ChunkState::TerrainGenerated))
+                mGeneratorQueue.Push(std::bind(&Chunk::Decorate, chunk, std::cref(mGenerator),
+                                               std::ref(mDecorationQueue)));
+            break;
+        case ChunkState::Decorated:
+            if (slot.visible && NeighboursReached(slot, ChunkState::Decorated) &&
+                chunk->ReserveTask(ChunkState::Decorated))
+                mGeneratorQueue.Push(std::bind(&Chunk::GenerateMesh, chunk, mMeshingMethod,
+                                               GetSideNeighbours(slot)));
+            break;
+        case ChunkState::Updated:
+            // Faces towards neighbours, which were missing during meshing, are hidden once the
+            // neighbours arrive. Same goes for changes of level of detail. Old Mesh is rendered
+            // until the new one is committed. Mesh state is only read once no task is writing it.
+            if (slot.visible && !chunk->IsTaskReserved())
+            {
+                ChunkNeighbours neighbours = GetSideNeighbours(slot);
+                if ((chunk->NeedsLodRemesh() || chunk->NeedsBorderRemesh(neighbours)) &&
+                    chunk->ReserveTask(ChunkState::Updated))
+                    mGeneratorQueue.Push(std::bind(&Chunk::GenerateMesh, chunk,
+                                                   mMeshingMethod, neighbours));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Create detached threads which will do the tasks in parallel. Threads quit once the queue
+    // is empty, so this is checked every frame.
+    while (!mGeneratorQueue.IsEmpty() && mGeneratorThreads < mMaxGeneratorThreads)
+    {
+        mGeneratorThreads++;
         std::thread generatorThread([this]() {
             mGeneratorQueue.EmptyWait();
+            mGeneratorThreads--;
         });
         generatorThread.detach();
     }
 }
 
+void TerrainManager::ScheduleEdits()
+{
+    // Edits of neighbours are appended while iterating, so they are indexed
+    size_t i = 0;
+    while (i < mPendingEdits.size())
+    {
+        VoxelEdit edit = mPendingEdits[i];
+        Chunk* chunk = mChunkPool.FindChunk(edit.coordX, edit.coordZ);
+        if (!chunk || chunk->GetState() < ChunkState::Generated)
+        {
+            mPendingEdits.erase(mPendingEdits.begin() + i);
+            continue;
+        }
+
+        // Neighbours' tasks read the border of edited chunk. Only this thread reserves chunks,
+        // so they stay unreserved until the voxel is changed.
+        ChunkNeighbours neighbours = mChunkPool.GetNeighbours(edit.coordX, edit.coordZ);
+        if ((!edit.neighbour && AnyTaskReserved(neighbours)) ||
+            !chunk->ReserveTask(ChunkState::Updated))
+        {
+            ++i;
+            continue;
+        }
+
+        if (!edit.neighbour)
+            chunk->SetVoxel(edit.x, edit.y, edit.z, edit.voxel);
+
+        mGeneratorQueue.PushUrgent(std::bind(&Chunk::RemeshAround, chunk,
+                                             edit.x, edit.y, edit.z, mMeshingMethod,
+                                             neighbours));
+        if (edit.measured)
+        {
+            edit.chunk = chunk;
+            mRunningEdits.push_back(edit);
+        }
+
+        mPendingEdits.erase(mPendingEdits.begin() + i);
+        if (!edit.neighbour)
+            PushNeighbourEdits(edit);
+    }
+}
+
+void TerrainManager::PushNeighbourEdits(const VoxelEdit& edit)
+{
+    // Voxel on the border might hide or reveal a face of the neighbour as well. For the
+    // neighbour, the voxel lies just outside of its side.
+    auto pushNeighbourEdit = [&](int dx, int dz)
+    {
+        VoxelEdit neighbourEdit = edit;
+        neighbourEdit.coordX += dx;
+        neighbourEdit.coordZ += dz;
+        neighbourEdit.x -= dx * CHUNK_X;
+        neighbourEdit.z -= dz * CHUNK_Z;
+        neighbourEdit.neighbour = true;
+        neighbourEdit.measured = false;
+        neighbourEdit.chunk = nullptr;
+        mPendingEdits.push_back(neighbourEdit);
+    };
+
+    if (edit.x == CHUNK_X - 1)
+        pushNeighbourEdit(1, 0);
+    else if (edit.x == 0)
+        pushNeighbourEdit(-1, 0);
+    if (edit.z == CHUNK_Z - 1)
+        pushNeighbourEdit(0, 1);
+    else if (edit.z == 0)
+        pushNeighbourEdit(0, -1);
+}
+
+void TerrainManager::FinishEdits(const Chunk* chunk) noexcept
+{
+    // Chunk was reserved for the edit, so the first Mesh committed afterwards is the edited one.
+    // It is drawn in this very frame.
+    auto edit = mRunningEdits.begin();
+    while (edit != mRunningEdits.end())
+    {
+        if (edit->chunk != chunk)
+        {
+            ++edit;
+            continue;
+        }
+
+        LOG_I("Voxel edit visible after " << edit->timer.Stop() * 1000.0 << " ms, "
+              << edit->frames << " frames.");
+        edit = mRunningEdits.erase(edit);
+    }
+}
+
+unsigned int TerrainManager::SelectLod(const Chunk* chunk, unsigned int ring) const noexcept
+{
+    if (mMeshingMethod != MeshingMethod::Greedy)
+        return 0;
+
+    // Chunks without a Mesh have nothing to rebuild, so they take the level right away
+    unsigned int hysteresis = (chunk->GetState() >= ChunkState::Generated) ? LOD_HYSTERESIS : 0;
+    unsigned int current = chunk->GetLod();
+    unsigned int lod = 0;
+    for (unsigned int level = 1; level < ChunkMesher::LOD_LEVEL_COUNT; ++level)
+    {
+        unsigned int radius = mLodRadius[level - 1];
+        if (radius == 0)
+            break;
+
+        // Coarser levels are entered further away than they are left
+        unsigned int threshold;
+        if (level > current)
+            threshold = radius + hysteresis;
+        else
+            threshold = (radius > hysteresis) ? radius - hysteresis : 0;
+
+        if (ring < threshold)
+            break;
+
+        lod = level;
+    }
+
+    return lod;
+}
+
+bool TerrainManager::NeighboursReached(const TerrainSlot& slot, ChunkState state) const noexcept
+{
+    for (const Chunk* neighbour : slot.neighbours)
+        if (!neighbour || neighbour->GetState() < state)
+            return false;
+
+    return true;
+}
+
 unsigned int TerrainManager::CalculateChunkCount(unsigned int radius)
 {
     if (radius == 0)
@@ -8,16 +8,25 @@
 #define __TERRAIN_TERRAINMANAGER_HPP__
 
 #include "ChunkPool.hpp"
+#include "Decoration.hpp"
+#include "TerrainGenerator.hpp"
 
+#include <atomic>
 #include <vector>
 
 #include "Common/TaskQueue.hpp"
+#include "Common/Timer.hpp"
 
 struct TerrainDesc
 {
     std::string terrainPath;        ///< Path to current save directory with terrain data.
     unsigned int visibleRadius;     ///< Visible chunks in straight line from current chunk.
-    bool useGreedyMeshing;
+    MeshingMethod meshingMethod;    ///< Method used to build Meshes of chunks.
+    /// Distance in chunks, from which each coarser level of detail is used. Must increase, 0 or
+    /// more than visibleRadius disables the level and all further ones. Greedy meshing only.
+    unsigned int lodRadius[ChunkMesher::LOD_LEVEL_COUNT - 1];
+    ChunkCompression chunkCompression; ///< Compression of chunks saved by this world.
+    TerrainGeneratorDesc generator; ///< Parameters of terrain generation.
 };
 
 /**
@@ -34,6 +43,34 @@ enum class GeneratorState: unsigned char
     ZIncXInc
 };
 
+/**
+ * Chunk taking part in generation around the player, along with its neighbourhood.
+ */
+struct TerrainSlot
+{
+    Chunk* chunk;               ///< Chunk in the slot.
+    Chunk* neighbours[8];       ///< Eight surrounding chunks, nullptr if outside of the region.
+    int coordX;                 ///< Chunk's X coordinate in the world.
+    int coordZ;                 ///< Chunk's Z coordinate in the world.
+    bool visible;               ///< Chunk is rendered, so it needs a Mesh.
+};
+
+/**
+ * Voxel changed by the player, waiting for Meshes around it to be rebuilt.
+ */
+struct VoxelEdit
+{
+    int coordX;                 ///< X coordinate of remeshed chunk in the world.
+    int coordZ;                 ///< Z coordinate of remeshed chunk in the world.
+    int x, y, z;                ///< Changed voxel. May lie one voxel outside of the chunk.
+    VoxelType voxel;            ///< New type of the voxel.
+    bool neighbour;             ///< Edit only remeshes a neighbour, the voxel is already changed.
+    bool measured;              ///< Latency of the edit is logged once its Mesh is committed.
+    const Chunk* chunk;         ///< Remeshed chunk, set once the task is scheduled.
+    unsigned int frames;        ///< Frames which passed since the edit.
+    Timer timer;                ///< Started when the voxel was changed.
+};
+
 class TerrainManager
 {
 public:
@@ -76,10 +113,71 @@ private:
     ~TerrainManager();
 
     /**
-     * Calls Chunk::Generate() per each available chunk.
+     * Collects visible chunks and the region of chunks needed to generate them.
+     *
+     * Visible chunk is meshed once it and all its neighbours are decorated, and decorating
+     * a chunk requires its neighbours to be terrain-complete. Hence the region covers two rings
+     * of chunks around every visible one.
      */
     void GenerateChunks();
 
+    /**
+     * Pushes tasks advancing chunks of the region to the generator queue.
+     *
+     * Each chunk is scheduled only when the work can be done right away and will not be repeated:
+     *   * terrain - for every chunk of the region
+     *   * decorations - when all neighbours are terrain-complete
+     *   * mesh - for visible chunks, when all neighbours are decorated
+     *   * remesh - for visible chunks meshed without some neighbours, when these arrive, and
+     *     for visible chunks which changed their level of detail, or whose neighbours did
+     *
+     * Pending voxel edits are scheduled before all of these, see ScheduleEdits().
+     */
+    void ScheduleTasks();
+
+    /**
+     * Picks a voxel by a ray from @p pos towards @p dir and queues its change, along with
+     * remeshing of chunks around it. See ScheduleEdits().
+     */
+    void EditPickedVoxel(const Vector& pos, const Vector& dir) noexcept;
+
+    /**
+     * Pushes remesh tasks of pending edits to the urgent lane of generator queue, ahead of
+     * terrain streaming. Chunks busy with another task, or with a Mesh waiting for commit, are
+     * retried in the next frame. Edits of chunks without a Mesh are dropped - their Mesh will be
+     * built from current voxels anyway.
+     *
+     * The voxel is changed once its chunk is reserved for the remesh and none of its side
+     * neighbours is reserved, as their tasks read the chunk's border. Only then edits of the
+     * neighbours are queued.
+     *
+     * Old Mesh stays on screen until the new one is committed in Update().
+     */
+    void ScheduleEdits();
+
+    /**
+     * Queues remeshing of neighbours bordering the voxel changed by @p edit.
+     */
+    void PushNeighbourEdits(const VoxelEdit& edit);
+
+    /**
+     * Logs latency of edits, whose Mesh was just committed in @p chunk.
+     */
+    void FinishEdits(const Chunk* chunk) noexcept;
+
+    /**
+     * Picks level of detail of visible @p chunk, lying @p ring chunks away from the player.
+     *
+     * Chunks with a Mesh switch levels only LOD_HYSTERESIS chunks past the configured radius,
+     * so walking back and forth over the border does not rebuild them every time.
+     */
+    unsigned int SelectLod(const Chunk* chunk, unsigned int ring) const noexcept;
+
+    /**
+     * Check if all neighbours of @p slot are present and reached at least @p state.
+     */
+    bool NeighboursReached(const TerrainSlot& slot, ChunkState state) const noexcept;
+
     /**
      * Calculate how many chunks we need for @p radius visible chunks.
      */
@@ -95,13 +193,21 @@ private:
     void ShiftChunkCoords(int& xChunk, int& zChunk, GeneratorState& state);
 
     ChunkPool mChunkPool;
+    TerrainGenerator mGenerator;
+    DecorationQueue mDecorationQueue;
     std::vector<Chunk*> mChunks;
+    std::vector<TerrainSlot> mRegion;
+    std::vector<VoxelEdit> mPendingEdits;   ///< Edits waiting for their chunk to be reserved.
+    std::vector<VoxelEdit> mRunningEdits;   ///< Measured edits, which are being remeshed.
     int mCurrentChunkX;
     int mCurrentChunkZ;
     unsigned int mChunkCount;
     unsigned int mVisibleRadius;
-    bool mUseGreedyMeshing;
+    MeshingMethod mMeshingMethod;
+    unsigned int mLodRadius[ChunkMesher::LOD_LEVEL_COUNT - 1];
     TaskQueue<> mGeneratorQueue;
+    std::atomic<unsigned int> mGeneratorThreads;
+    unsigned int mMaxGeneratorThreads;
 };
 
 #endif // __TERRAIN_TERRAINMANAGER_HPP__
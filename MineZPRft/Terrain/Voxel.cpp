@@ -47,6 +47,66 @@ const VoxelDBType VoxelDB =
         }
     },
 
+    /**
+     * Soft ground found right below the surface of grassy and snowy biomes.
+     */
+    {
+        VoxelType::Dirt,
+        {
+            0.45f, 0.3f, 0.15f,
+        }
+    },
+
+    /**
+     * Dirt overgrown with grass, covers the surface of Plains biome.
+     */
+    {
+        VoxelType::Grass,
+        {
+            0.3f, 0.65f, 0.2f,
+        }
+    },
+
+    /**
+     * Covers the surface of Desert biome, all the way down to the stone.
+     */
+    {
+        VoxelType::Sand,
+        {
+            0.9f, 0.85f, 0.55f,
+        }
+    },
+
+    /**
+     * Covers the surface of Tundra biome.
+     */
+    {
+        VoxelType::Snow,
+        {
+            0.95f, 0.95f, 1.0f,
+        }
+    },
+
+    /**
+     * Trunk of a tree, placed by terrain decorations.
+     */
+    {
+        VoxelType::Wood,
+        {
+            0.35f, 0.22f, 0.1f,
+        }
+    },
+
+    /**
+     * Crown of a tree, placed by terrain decorations.
+     */
+    {
+        VoxelType::Leaves,
+        {
+            0.15f, 0.45f, 0.1f,
+        }
+    },
+
     /**
      * The Voxel That Shall Not Be Used, aka. The Unknown Voxel. This voxel should be a default
      * returned value when provided Voxel type by user is not available.
@@ -20,6 +20,12 @@ enum class VoxelType : unsigned char
     Air = 0,
     Bedrock,
     Stone,
+    Dirt,
+    Grass,
+    Sand,
+    Snow,
+    Wood,
+    Leaves,
     Unknown
 };
 
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Bulk voxel fill definitions.
+ */
+
+#include "VoxelFill.hpp"
+
+#include <cstring>
+
+static_assert(sizeof(VoxelType) == 1, "Voxel fills rely on memset, VoxelType must be a byte");
+
+namespace
+{
+
+size_t VoxelIndex(int x, int y, int z)
+{
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+} // namespace
+
+
+void FillColumn(VoxelType* voxels, int x, int z, int yBegin, int yEnd, VoxelType voxel) noexcept
+{
+    VoxelType* ptr = voxels + VoxelIndex(x, yBegin, z);
+    for (int y = yBegin; y < yEnd; ++y, ptr += CHUNK_Z)
+        *ptr = voxel;
+}
+
+void FillLayer(VoxelType* voxels, int yBegin, int yEnd, VoxelType voxel) noexcept
+{
+    FillBox(voxels, 0, yBegin, 0, CHUNK_X, yEnd, CHUNK_Z, voxel);
+}
+
+void FillBox(VoxelType* voxels, int x0, int y0, int z0, int x1, int y1, int z1,
+             VoxelType voxel) noexcept
+{
+    if (x0 >= x1 || y0 >= y1 || z0 >= z1)
+        return;
+
+    int value = static_cast<VoxelUnderType>(voxel);
+
+    // Whole X slices - the box is one contiguous span
+    if (y0 == 0 && y1 == CHUNK_Y && z0 == 0 && z1 == CHUNK_Z)
+    {
+        memset(voxels + VoxelIndex(x0, 0, 0), value,
+               static_cast<size_t>(x1 - x0) * CHUNK_Y * CHUNK_Z);
+        return;
+    }
+
+    // Whole Z rows - consecutive layers of a slice form one contiguous span
+    if (z0 == 0 && z1 == CHUNK_Z)
+    {
+        size_t sliceSpan = static_cast<size_t>(y1 - y0) * CHUNK_Z;
+        for (int x = x0; x < x1; ++x)
+            memset(voxels + VoxelIndex(x, y0, 0), value, sliceSpan);
+        return;
+    }
+
+    size_t rowSpan = static_cast<size_t>(z1 - z0);
+    for (int x = x0; x < x1; ++x)
+        for (int y = y0; y < y1; ++y)
+            memset(voxels + VoxelIndex(x, y, z0), value, rowSpan);
+}
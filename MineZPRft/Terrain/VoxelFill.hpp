@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Bulk voxel fill declarations.
+ */
+
+#ifndef __TERRAIN_VOXELFILL_HPP__
+#define __TERRAIN_VOXELFILL_HPP__
+
+#include "Defines.hpp"
+#include "Voxel.hpp"
+
+/**
+ * Bulk fill primitives working on raw voxel arrays of CHUNK_VOXEL_COUNT voxels, laid out the same
+ * way as Chunk's internal array - index = x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z.
+ *
+ * In this layout Z rows are contiguous, and so is a whole X slice. Primitives write such
+ * contiguous spans at once, instead of going voxel by voxel.
+ *
+ * Ranges are half-open - [begin, end). For performance no bounds checking is done, so callers
+ * must keep the coordinates within chunk dimensions. Empty ranges are allowed.
+ */
+
+/**
+ * Fill a vertical span of voxels in column [@p x, @p z].
+ *
+ * @param voxels Voxel array to fill.
+ * @param x      X coordinate of the column.
+ * @param z      Z coordinate of the column.
+ * @param yBegin First Y coordinate to fill.
+ * @param yEnd   Y coordinate past the last one to fill.
+ * @param voxel  Type of voxel to write.
+ */
+void FillColumn(VoxelType* voxels, int x, int z, int yBegin, int yEnd, VoxelType voxel) noexcept;
+
+/**
+ * Fill layers [@p yBegin, @p yEnd) of the whole chunk.
+ *
+ * @param voxels Voxel array to fill.
+ * @param yBegin First Y coordinate to fill.
+ * @param yEnd   Y coordinate past the last one to fill.
+ * @param voxel  Type of voxel to write.
+ */
+void FillLayer(VoxelType* voxels, int yBegin, int yEnd, VoxelType voxel) noexcept;
+
+/**
+ * Fill box [@p x0, @p x1) x [@p y0, @p y1) x [@p z0, @p z1).
+ *
+ * @param voxels Voxel array to fill.
+ * @param voxel  Type of voxel to write.
+ *
+ * Boxes spanning whole Z range are written with a single store per X slice.
+ */
+void FillBox(VoxelType* voxels, int x0, int y0, int z0, int x1, int y1, int z1,
+             VoxelType voxel) noexcept;
+
+#endif // __TERRAIN_VOXELFILL_HPP__
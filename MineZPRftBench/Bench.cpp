@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Benchmark framework definitions
+ */
+
+#include "Bench.hpp"
+
+#include "Terrain/TerrainGenerator.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const int BENCH_ROW_LENGTH = 16;
+const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+} // namespace
+
+BenchRegistry& BenchRegistry::GetInstance()
+{
+    static BenchRegistry instance;
+    return instance;
+}
+
+bool BenchRegistry::Register(const std::string& name, BenchFunc func)
+{
+    mEntries.push_back({name, func});
+    return true;
+}
+
+unsigned int BenchRegistry::Run(const BenchDesc& desc, const std::string& filter) const
+{
+    unsigned int count = 0;
+    for (const auto& entry : mEntries)
+    {
+        if (entry.name.find(filter) == std::string::npos)
+            continue;
+
+        std::cout << "[ BENCH ] " << entry.name << std::endl;
+        entry.func(desc);
+        count++;
+    }
+
+    return count;
+}
+
+std::vector<VoxelType> GenerateBenchChunks(const BenchDesc& desc)
+{
+    std::vector<VoxelType> voxels(static_cast<size_t>(desc.chunkCount) * CHUNK_VOXEL_COUNT);
+    TerrainGeneratorDesc generatorDesc;
+    generatorDesc.seed = desc.seed;
+    TerrainGenerator generator;
+    generator.Init(generatorDesc);
+
+    int x, z;
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        generator.Generate(voxels.data() + static_cast<size_t>(i) * CHUNK_VOXEL_COUNT, x, z);
+    }
+
+    return voxels;
+}
+
+void GetBenchChunkCoords(unsigned int index, int& x, int& z)
+{
+    // Lay chunks out in rows of BENCH_ROW_LENGTH, starting next to world origin
+    x = static_cast<int>(index % BENCH_ROW_LENGTH) - BENCH_ROW_LENGTH / 2;
+    z = static_cast<int>(index / BENCH_ROW_LENGTH) - BENCH_ROW_LENGTH / 2;
+}
+
+void ReportResult(const std::string& name, double value, const std::string& unit)
+{
+    std::cout << "    " << std::left << std::setw(40) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(3) << value
+              << ' ' << unit << std::endl;
+}
+
+void ReportHash(const std::string& name, uint64_t hash)
+{
+    std::cout << "    " << std::left << std::setw(40) << name
+              << std::right << "    " << std::hex << std::setfill('0') << std::setw(16) << hash
+              << std::dec << std::setfill(' ') << std::endl;
+}
+
+uint64_t HashContent(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
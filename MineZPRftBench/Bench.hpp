@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Benchmark framework declarations
+ */
+
+#ifndef __BENCH_BENCH_HPP__
+#define __BENCH_BENCH_HPP__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Terrain/Voxel.hpp"
+
+/**
+ * Parameters shared by all benchmarks, set from command line.
+ */
+struct BenchDesc
+{
+    unsigned int chunkCount;    ///< Amount of chunks each benchmark should process.
+    uint32_t seed;              ///< Seed used to generate terrain. 0 selects reference noise.
+    unsigned int threadCount;   ///< Amount of threads used by multithreaded benchmarks.
+    bool printHashes;           ///< Print content hash of every processed chunk.
+};
+
+typedef void (*BenchFunc)(const BenchDesc& desc);
+
+/**
+ * Keeps all benchmarks defined with BENCHMARK macro.
+ */
+class BenchRegistry
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        BenchFunc func;
+    };
+
+    static BenchRegistry& GetInstance();
+
+    /**
+     * Register a new benchmark. Used by BENCHMARK macro.
+     */
+    bool Register(const std::string& name, BenchFunc func);
+
+    /**
+     * Run all benchmarks whose name contains @p filter.
+     *
+     * @return Amount of benchmarks run.
+     */
+    unsigned int Run(const BenchDesc& desc, const std::string& filter) const;
+
+private:
+    std::vector<Entry> mEntries;
+};
+
+/**
+ * Define a benchmark. Usage is similar to gtest's TEST macro:
+ * <code>
+ * BENCHMARK(Name)
+ * {
+ *     // desc is available here
+ * }
+ * </code>
+ */
+#define BENCHMARK(name)                                                                     \
+static void Bench##name(const BenchDesc& desc);                                             \
+static const bool gBench##name##Registered =                                                \
+    BenchRegistry::GetInstance().Register(#name, &Bench##name);                             \
+static void Bench##name(const BenchDesc& desc)
+
+/**
+ * Generate @p desc.chunkCount chunks in a square-ish area around world center.
+ *
+ * @return Voxels of all chunks, one after another (CHUNK_VOXEL_COUNT voxels per chunk).
+ */
+std::vector<VoxelType> GenerateBenchChunks(const BenchDesc& desc);
+
+/**
+ * Acquire coordinates of @p index-th chunk generated by GenerateBenchChunks().
+ */
+void GetBenchChunkCoords(unsigned int index, int& x, int& z);
+
+/**
+ * Print a single result line.
+ *
+ * @param name  Name of measured value.
+ * @param value Measured value.
+ * @param unit  Unit of @p value.
+ */
+void ReportResult(const std::string& name, double value, const std::string& unit);
+
+/**
+ * Print a content hash line.
+ *
+ * @param name Name of hashed content.
+ * @param hash Hash, ex. from HashContent().
+ */
+void ReportHash(const std::string& name, uint64_t hash);
+
+/**
+ * Calculate 64-bit FNV-1a hash of @p size bytes at @p data.
+ *
+ * @param data Hashed bytes.
+ * @param size Amount of hashed bytes.
+ * @param hash Hash of preceding content, allowing to hash non-contiguous data piece by piece.
+ *
+ * Hashes are meant to compare outputs of benchmarked code before and after an optimization, so
+ * they only need to be deterministic, not strong.
+ */
+uint64_t HashContent(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull);
+
+#endif // __BENCH_BENCH_HPP__
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk serialization and compression benchmarks
+ */
+
+#include "Bench.hpp"
+
+#include "Common/Timer.hpp"
+#include "Terrain/ChunkSerializer.hpp"
+
+namespace {
+
+void MeasureCodec(const BenchDesc& desc, const std::vector<VoxelType>& chunks,
+                  ChunkCompression compression, const std::string& name)
+{
+    std::vector<std::vector<unsigned char>> serialized(desc.chunkCount);
+    std::vector<VoxelType> decoded(CHUNK_VOXEL_COUNT);
+    Timer timer;
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+        ChunkSerializer::Serialize(chunks.data() + static_cast<size_t>(i) * CHUNK_VOXEL_COUNT,
+                                   compression, serialized[i]);
+    double encodeTime = timer.Stop();
+
+    size_t serializedSize = 0;
+    for (const auto& data : serialized)
+        serializedSize += data.size();
+
+    bool valid = true;
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+        valid &= ChunkSerializer::Deserialize(serialized[i], decoded.data());
+    double decodeTime = timer.Stop();
+
+    if (!valid)
+    {
+        ReportResult(name + " FAILED to decode", 0.0, "");
+        return;
+    }
+
+    // Throughput is given in terms of raw voxel data, so all codecs are comparable
+    double rawMB = static_cast<double>(desc.chunkCount) * CHUNK_VOXEL_COUNT / (1024.0 * 1024.0);
+    ReportResult(name + " ratio", static_cast<double>(desc.chunkCount) * CHUNK_VOXEL_COUNT /
+                 static_cast<double>(serializedSize), ":1");
+    ReportResult(name + " size per chunk",
+                 static_cast<double>(serializedSize) / desc.chunkCount, "B");
+    ReportResult(name + " encode", rawMB / encodeTime, "MB/s");
+    ReportResult(name + " decode", rawMB / decodeTime, "MB/s");
+}
+
+} // namespace
+
+
+BENCHMARK(ChunkCompression)
+{
+    std::vector<VoxelType> chunks = GenerateBenchChunks(desc);
+
+    MeasureCodec(desc, chunks, ChunkCompression::RLE, "RLE");
+    MeasureCodec(desc, chunks, ChunkCompression::LZ, "RLE+LZ");
+}
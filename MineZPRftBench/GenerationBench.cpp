@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain generation benchmarks
+ */
+
+#include "Bench.hpp"
+
+#include "Common/Timer.hpp"
+#include "Terrain/TerrainGenerator.hpp"
+
+namespace {
+
+void MeasureGeneration(const BenchDesc& desc, const TerrainGeneratorDesc& generatorDesc,
+                       const std::string& name)
+{
+    TerrainGenerator generator;
+    generator.Init(generatorDesc);
+
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    Timer timer;
+    int x, z;
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        generator.Generate(voxels.data(), x, z);
+    }
+    double time = timer.Stop();
+
+    ReportResult(name, desc.chunkCount / time, "chunks/s");
+    ReportResult(name + " per chunk", time / desc.chunkCount * 1.0e6, "us");
+}
+
+} // namespace
+
+
+BENCHMARK(TerrainGeneration)
+{
+    TerrainGeneratorDesc generatorDesc;
+    generatorDesc.seed = desc.seed;
+
+    generatorDesc.caves = false;
+    MeasureGeneration(desc, generatorDesc, "Caves off");
+
+    generatorDesc.caves = true;
+    MeasureGeneration(desc, generatorDesc, "Caves on");
+
+    generatorDesc.biomes = true;
+    MeasureGeneration(desc, generatorDesc, "Caves and biomes on");
+}
+
+BENCHMARK(Biomes)
+{
+    // Heightmap as configured by the game
+    TerrainGeneratorDesc generatorDesc;
+    generatorDesc.seed = desc.seed;
+    generatorDesc.heightmap.octaves = 4;
+    generatorDesc.heightmap.frequency = 1.0 / 64.0;
+    TerrainGenerator generator;
+    generator.Init(generatorDesc);
+
+    NoiseGenerator noiseGen(desc.seed);
+    FractalNoise heightmapNoise(generatorDesc.heightmap);
+    float heightMap[CHUNK_X * CHUNK_Z];
+    ChunkClimate climate;
+    Biome biomes[CHUNK_X * CHUNK_Z];
+    Timer timer;
+    int x, z;
+
+    // Heightmap stage without the cache, the same work generator does on a miss
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        heightmapNoise.GenerateTile(noiseGen, CHUNK_Z * z, CHUNK_X * x, CHUNK_X, CHUNK_Z,
+                                    heightMap);
+    }
+    double heightmapTime = timer.Stop();
+    ReportResult("Heightmap stage", heightmapTime / desc.chunkCount * 1.0e6, "us/chunk");
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        generator.GetClimate(x, z, climate);
+        for (int j = 0; j < CHUNK_X * CHUNK_Z; ++j)
+            biomes[j] = SelectBiome(climate.temperature[j], climate.humidity[j]);
+    }
+    double biomeTime = timer.Stop();
+    ReportResult("Biome stage", biomeTime / desc.chunkCount * 1.0e6, "us/chunk");
+    ReportResult("Biome stage cost", biomeTime / heightmapTime * 100.0, "% of heightmap");
+
+    // Keep the results alive, so the loop is not optimized away
+    size_t plains = 0;
+    for (Biome biome : biomes)
+        if (biome == Biome::Plains)
+            plains++;
+    ReportResult("Plains columns in last chunk", static_cast<double>(plains), "");
+}
+
+BENCHMARK(NoiseTileCache)
+{
+    TerrainGeneratorDesc generatorDesc;
+    generatorDesc.seed = desc.seed;
+    TerrainGenerator generator;
+    generator.Init(generatorDesc);
+
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    float heightMap[CHUNK_X * CHUNK_Z];
+    Timer timer;
+    int x, z;
+
+    // First pass fills the cache, second one simulates regeneration of evicted chunks
+    const char* passes[] = { "Cold", "Warm" };
+    for (const char* pass : passes)
+    {
+        timer.Start();
+        for (unsigned int i = 0; i < desc.chunkCount; ++i)
+        {
+            GetBenchChunkCoords(i, x, z);
+            generator.Generate(voxels.data(), x, z);
+        }
+        double time = timer.Stop();
+        ReportResult(std::string(pass) + " generation", desc.chunkCount / time, "chunks/s");
+    }
+
+    // Neighbour lookups, as done by stages which need border heights
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        generator.GetHeightmapNoise(x + 1, z, heightMap);
+        generator.GetHeightmapNoise(x, z + 1, heightMap);
+    }
+    double time = timer.Stop();
+    ReportResult("Neighbour heightmap lookup", time / (2.0 * desc.chunkCount) * 1.0e6, "us");
+
+    const NoiseTileCache& cache = generator.GetNoiseTileCache();
+    ReportResult("Hits", static_cast<double>(cache.GetHitCount()), "");
+    ReportResult("Misses", static_cast<double>(cache.GetMissCount()), "");
+    ReportResult("Hit rate", cache.GetHitRate() * 100.0, "%");
+}
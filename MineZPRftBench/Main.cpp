@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Main function of benchmark application
+ */
+
+#include "Bench.hpp"
+
+#include "Common/Common.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const unsigned int DEFAULT_CHUNK_COUNT = 256;
+
+void PrintUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [--chunks N] [--seed S] [--threads N] [--hashes]"
+              << " [--filter NAME]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchDesc desc;
+    desc.chunkCount = DEFAULT_CHUNK_COUNT;
+    desc.seed = 0;
+    desc.threadCount = 1;
+    desc.printHashes = false;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = (i + 1 < argc);
+        if (hasValue && strcmp(argv[i], "--chunks") == 0 && IsNumeric(argv[i + 1]))
+            desc.chunkCount = std::stoul(argv[++i]);
+        else if (hasValue && strcmp(argv[i], "--seed") == 0 && IsNumeric(argv[i + 1]))
+            desc.seed = std::stoul(argv[++i]);
+        else if (hasValue && strcmp(argv[i], "--threads") == 0 && IsNumeric(argv[i + 1]))
+            desc.threadCount = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--hashes") == 0)
+            desc.printHashes = true;
+        else if (hasValue && strcmp(argv[i], "--filter") == 0)
+            filter = argv[++i];
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (desc.chunkCount == 0 || desc.threadCount == 0)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "Running benchmarks on " << desc.chunkCount << " chunks, seed "
+              << desc.seed << ", " << desc.threadCount << " threads" << std::endl;
+
+    if (BenchRegistry::GetInstance().Run(desc, filter) == 0)
+    {
+        std::cout << "No benchmarks match filter \"" << filter << "\"" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Noise generation benchmarks
+ */
+
+#include "Bench.hpp"
+
+#include "Common/Timer.hpp"
+#include "Terrain/Defines.hpp"
+#include "Terrain/FractalNoise.hpp"
+#include "Terrain/NoiseGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Every chunk contributes a full 3D grid, the same amount of points cave stage evaluates
+const size_t POINTS_PER_CHUNK = CHUNK_VOXEL_COUNT;
+const float NOISE_SCALE = 0.1f;
+
+// Report throughput of a single run and return its time, so kernels can be compared
+double ReportThroughput(const std::string& name, size_t pointCount, double time)
+{
+    ReportResult(name, static_cast<double>(pointCount) / time / 1.0e6, "Mpoints/s");
+    return time;
+}
+
+} // namespace
+
+
+BENCHMARK(NoiseBatch)
+{
+    size_t pointCount = static_cast<size_t>(desc.chunkCount) * POINTS_PER_CHUNK;
+
+    std::vector<float> xs(pointCount);
+    std::vector<float> ys(pointCount);
+    std::vector<float> zs(pointCount);
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        int chunkX, chunkZ;
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+
+        size_t point = static_cast<size_t>(i) * POINTS_PER_CHUNK;
+        for (int x = 0; x < CHUNK_X; ++x)
+            for (int y = 0; y < CHUNK_Y; ++y)
+                for (int z = 0; z < CHUNK_Z; ++z, ++point)
+                {
+                    xs[point] = (x + CHUNK_X * chunkX) * NOISE_SCALE;
+                    ys[point] = y * NOISE_SCALE;
+                    zs[point] = (z + CHUNK_Z * chunkZ) * NOISE_SCALE;
+                }
+    }
+
+    const struct
+    {
+        NoiseBackend backend;
+        const char* name;
+    } backends[] = {
+        { NoiseBackend::Permutation, "Permutation" },
+        { NoiseBackend::Hash, "Hash" },
+    };
+
+    const struct
+    {
+        NoiseSIMD simd;
+        const char* name;
+    } kernels[] = {
+        { NoiseSIMD::Scalar, "NoiseBatch() Scalar" },
+        { NoiseSIMD::SSE4, "NoiseBatch() SSE4" },
+        { NoiseSIMD::AVX2, "NoiseBatch() AVX2" },
+    };
+
+    std::vector<float> reference(pointCount);
+    std::vector<float> out(pointCount);
+    Timer timer;
+
+    // Times of permutation backend, to compare hash backend against
+    double permutationTimes[1 + sizeof(kernels) / sizeof(kernels[0])] = { 0.0 };
+
+    for (const auto& backend : backends)
+    {
+        NoiseGenerator noiseGen(desc.seed, backend.backend);
+        const std::string prefix = std::string(backend.name) + ' ';
+        const bool isPermutation = (backend.backend == NoiseBackend::Permutation);
+
+        // Reference - one point at a time, in double precision
+        timer.Start();
+        for (size_t i = 0; i < pointCount; ++i)
+            reference[i] = static_cast<float>(noiseGen.Noise<double>(xs[i], ys[i], zs[i]));
+        double scalarTime = ReportThroughput(prefix + "Noise()", pointCount, timer.Stop());
+        if (isPermutation)
+            permutationTimes[0] = scalarTime;
+        else
+            ReportResult(prefix + "Noise() vs Permutation", permutationTimes[0] / scalarTime, "x");
+
+        for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k)
+        {
+            const std::string name = prefix + kernels[k].name;
+            if (kernels[k].simd > noiseGen.GetSupportedSIMD())
+            {
+                ReportResult(name + " not supported", 0.0, "");
+                continue;
+            }
+
+            timer.Start();
+            noiseGen.NoiseBatch(xs.data(), ys.data(), zs.data(), out.data(), pointCount,
+                                kernels[k].simd);
+            double time = ReportThroughput(name, pointCount, timer.Stop());
+
+            float maxError = 0.0f;
+            for (size_t i = 0; i < pointCount; ++i)
+                maxError = std::max(maxError, std::abs(out[i] - reference[i]));
+
+            ReportResult(name + " speedup", scalarTime / time, "x");
+            ReportResult(name + " max error", maxError, "");
+            if (isPermutation)
+                permutationTimes[k + 1] = time;
+            else
+                ReportResult(name + " vs Permutation", permutationTimes[k + 1] / time, "x");
+        }
+    }
+}
+
+BENCHMARK(Heightmap)
+{
+    NoiseGenerator noiseGen(desc.seed);
+    const size_t tileSize = CHUNK_X * CHUNK_Z;
+    const double scale = 1.0 / 32.0;
+
+    std::vector<float> heightMap(tileSize);
+    std::vector<double> heightMapDouble(tileSize);
+    std::vector<float> xs(tileSize);
+    std::vector<float> ys(tileSize, 0.0f);
+    std::vector<float> zs(tileSize);
+    Timer timer;
+    double time;
+    int chunkX, chunkZ;
+
+    auto reportPerChunk = [&desc](const std::string& name, double time, double referenceTime)
+    {
+        ReportResult(name, time / desc.chunkCount * 1.0e6, "us/chunk");
+        if (referenceTime > 0.0)
+            ReportResult(name + " speedup", referenceTime / time, "x");
+    };
+
+    // Reference - 3D noise sampled on a plane, one point at a time
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        for (int z = 0; z < CHUNK_Z; ++z)
+            for (int x = 0; x < CHUNK_X; ++x)
+                heightMap[z * CHUNK_X + x] = static_cast<float>(
+                    noiseGen.Noise((x + CHUNK_Z * chunkZ) * scale, 0.0,
+                                   (z + CHUNK_X * chunkX) * scale));
+    }
+    double referenceTime = timer.Stop();
+    reportPerChunk("3D Noise()", referenceTime, 0.0);
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        for (int z = 0; z < CHUNK_Z; ++z)
+            for (int x = 0; x < CHUNK_X; ++x)
+            {
+                xs[z * CHUNK_X + x] = static_cast<float>((x + CHUNK_Z * chunkZ) * scale);
+                zs[z * CHUNK_X + x] = static_cast<float>((z + CHUNK_X * chunkX) * scale);
+            }
+        noiseGen.NoiseBatch(xs.data(), ys.data(), zs.data(), heightMap.data(), tileSize);
+    }
+    time = timer.Stop();
+    reportPerChunk("3D NoiseBatch()", time, referenceTime);
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        for (int z = 0; z < CHUNK_Z; ++z)
+            for (int x = 0; x < CHUNK_X; ++x)
+                heightMap[z * CHUNK_X + x] = static_cast<float>(
+                    noiseGen.Noise2D((x + CHUNK_Z * chunkZ) * scale,
+                                     (z + CHUNK_X * chunkX) * scale));
+    }
+    time = timer.Stop();
+    reportPerChunk("2D Noise2D()", time, referenceTime);
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        noiseGen.Noise2DTile(CHUNK_Z * chunkZ * scale, CHUNK_X * chunkX * scale, scale,
+                             CHUNK_X, CHUNK_Z, heightMapDouble.data());
+    }
+    time = timer.Stop();
+    reportPerChunk("2D Noise2DTile() double", time, referenceTime);
+
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        noiseGen.Noise2DTile<float>(CHUNK_Z * chunkZ * scale, CHUNK_X * chunkX * scale, scale,
+                                    CHUNK_X, CHUNK_Z, heightMap.data());
+    }
+    time = timer.Stop();
+    reportPerChunk("2D Noise2DTile()", time, referenceTime);
+
+    NoiseGenerator hashNoiseGen(desc.seed, NoiseBackend::Hash);
+    timer.Start();
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, chunkX, chunkZ);
+        hashNoiseGen.Noise2DTile<float>(CHUNK_Z * chunkZ * scale, CHUNK_X * chunkX * scale,
+                                        scale, CHUNK_X, CHUNK_Z, heightMap.data());
+    }
+    time = timer.Stop();
+    reportPerChunk("2D Noise2DTile() Hash", time, referenceTime);
+
+    const struct
+    {
+        FractalType type;
+        const char* name;
+    } fractals[] = {
+        { FractalType::FBM, "fBm" },
+        { FractalType::Ridged, "Ridged" },
+    };
+
+    for (const auto& fractal : fractals)
+    {
+        FractalDesc fractalDesc;
+        fractalDesc.type = fractal.type;
+        fractalDesc.octaves = 4;
+        FractalNoise noise(fractalDesc);
+
+        timer.Start();
+        for (unsigned int i = 0; i < desc.chunkCount; ++i)
+        {
+            GetBenchChunkCoords(i, chunkX, chunkZ);
+            noise.GenerateTile(noiseGen, CHUNK_Z * chunkZ, CHUNK_X * chunkX,
+                               CHUNK_X, CHUNK_Z, heightMap.data());
+        }
+        time = timer.Stop();
+        reportPerChunk(std::string(fractal.name) + " 4 octaves", time, referenceTime);
+    }
+}
@@ -0,0 +1,339 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Per-stage terrain pipeline benchmarks
+ *
+ * Every stage of the path from noise to a saved chunk is timed separately, chunk by chunk. Each
+ * stage also hashes its output, so an optimized stage can be checked to produce bit-identical
+ * results by comparing hashes printed before and after the change.
+ */
+
+#include "Bench.hpp"
+
+#include "Common/Timer.hpp"
+#include "Terrain/ChunkMesher.hpp"
+#include "Terrain/ChunkSerializer.hpp"
+#include "Terrain/TerrainGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+/**
+ * Buffers reused by a single thread between chunks, so stages do not measure allocations.
+ */
+struct PipelineScratch
+{
+    float heightMap[CHUNK_X * CHUNK_Z];
+    std::vector<VoxelType> voxels;
+    std::vector<unsigned char> faces;
+    std::vector<float> verts;
+    std::vector<PackedVertex> packedVerts;
+    std::vector<CubeInstance> instances;
+    std::vector<unsigned char> data;
+
+    PipelineScratch()
+        : voxels(CHUNK_VOXEL_COUNT)
+        , faces(CHUNK_VOXEL_COUNT)
+    {
+    }
+};
+
+/**
+ * Processes @p index-th chunk and returns the hash of its output.
+ */
+typedef std::function<uint64_t(unsigned int index, PipelineScratch& scratch)> StageFunc;
+
+/**
+ * Inputs of stages, which need results of earlier stages.
+ */
+struct PipelineInput
+{
+    std::vector<VoxelType> voxels;                  ///< Generated chunks, one after another.
+    std::vector<ChunkApron> aprons;                 ///< Borders of chunks' neighbours.
+    std::vector<std::vector<unsigned char>> data;   ///< Serialized chunks.
+};
+
+const VoxelType* GetChunkVoxels(const PipelineInput& input, unsigned int index)
+{
+    return input.voxels.data() + static_cast<size_t>(index) * CHUNK_VOXEL_COUNT;
+}
+
+double GetPercentile(const std::vector<double>& sorted, double percentile)
+{
+    size_t rank = static_cast<size_t>(percentile * sorted.size() / 100.0 + 0.5);
+    return sorted[std::min(std::max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+
+// Run @p stage on all chunks, picked one by one by desc.threadCount threads, and report times of
+// single chunks and throughput. Returns combined hash of all chunks, in chunk order.
+uint64_t MeasureStage(const BenchDesc& desc, const std::string& name, const StageFunc& stage)
+{
+    std::vector<double> times(desc.chunkCount);
+    std::vector<uint64_t> hashes(desc.chunkCount);
+    std::atomic<unsigned int> nextChunk(0);
+
+    auto worker = [&]()
+    {
+        PipelineScratch scratch;
+        Timer timer;
+        for (unsigned int i = nextChunk++; i < desc.chunkCount; i = nextChunk++)
+        {
+            timer.Start();
+            hashes[i] = stage(i, scratch);
+            times[i] = timer.Stop() * 1.0e6;
+        }
+    };
+
+    Timer wallTimer;
+    wallTimer.Start();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < desc.threadCount; ++i)
+        threads.emplace_back(worker);
+    for (auto& thread : threads)
+        thread.join();
+    double wallTime = wallTimer.Stop();
+
+    double busyTime = 0.0;
+    for (double time : times)
+        busyTime += time;
+    std::sort(times.begin(), times.end());
+
+    ReportResult(name + " median", GetPercentile(times, 50.0), "us/chunk");
+    ReportResult(name + " p99", GetPercentile(times, 99.0), "us/chunk");
+    ReportResult(name + " per thread", desc.chunkCount / busyTime * 1.0e6, "chunks/s");
+    if (desc.threadCount > 1)
+        ReportResult(name + " total", desc.chunkCount / wallTime, "chunks/s");
+
+    int x, z;
+    uint64_t hash = HashContent(nullptr, 0);
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        if (desc.printHashes)
+        {
+            GetBenchChunkCoords(i, x, z);
+            std::ostringstream chunkName;
+            chunkName << name << " [" << x << ", " << z << "]";
+            ReportHash(chunkName.str(), hashes[i]);
+        }
+
+        hash = HashContent(&hashes[i], sizeof(hashes[i]), hash);
+    }
+
+    ReportHash(name + " content hash", hash);
+    return hash;
+}
+
+} // namespace
+
+
+BENCHMARK(TerrainPipeline)
+{
+    // Terrain as generated by the game
+    TerrainGeneratorDesc generatorDesc = GetWorldGeneratorDesc(desc.seed);
+    TerrainGenerator generator;
+    generator.Init(generatorDesc);
+    NoiseGenerator noiseGen(generatorDesc.seed, generatorDesc.noiseBackend);
+    FractalNoise heightmapNoise(generatorDesc.heightmap);
+
+    // Results of earlier stages are prepared up front, so every stage can be measured alone.
+    // Generating the chunks also fills generator's noise tile cache.
+    PipelineInput input;
+    input.voxels.resize(static_cast<size_t>(desc.chunkCount) * CHUNK_VOXEL_COUNT);
+    input.data.resize(desc.chunkCount);
+    int x, z;
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        VoxelType* voxels = input.voxels.data() + static_cast<size_t>(i) * CHUNK_VOXEL_COUNT;
+        generator.Generate(voxels, x, z);
+        ChunkSerializer::Serialize(voxels, ChunkCompression::LZ, input.data[i]);
+    }
+
+    // Chunks are meshed with neighbours' borders, like in the game. Neighbours outside of the
+    // benchmarked area are missing, so faces on the outer edge of the area stay visible.
+    std::map<std::pair<int, int>, unsigned int> chunkIndex;
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        chunkIndex[std::make_pair(x, z)] = i;
+    }
+
+    auto findNeighbour = [&](int neighbourX, int neighbourZ) -> const VoxelType*
+    {
+        auto it = chunkIndex.find(std::make_pair(neighbourX, neighbourZ));
+        return (it == chunkIndex.end()) ? nullptr : GetChunkVoxels(input, it->second);
+    };
+
+    input.aprons.resize(desc.chunkCount);
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        GetBenchChunkCoords(i, x, z);
+        ChunkMesher::BuildApron(findNeighbour(x + 1, z), findNeighbour(x - 1, z),
+                                findNeighbour(x, z + 1), findNeighbour(x, z - 1),
+                                input.aprons[i]);
+    }
+
+    // Heightmap noise, without the tile cache - the work generator does on a cache miss
+    StageFunc heightmap = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        int chunkX, chunkZ;
+        GetBenchChunkCoords(index, chunkX, chunkZ);
+        heightmapNoise.GenerateTile(noiseGen, CHUNK_Z * chunkZ, CHUNK_X * chunkX, CHUNK_X,
+                                    CHUNK_Z, scratch.heightMap);
+        return HashContent(scratch.heightMap, sizeof(scratch.heightMap));
+    };
+
+    // Everything generator does after the heightmap - climate, column fill, caves and surface.
+    // Heightmap comes from the tile cache, unless there are more chunks than cached tiles.
+    StageFunc fill = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        int chunkX, chunkZ;
+        GetBenchChunkCoords(index, chunkX, chunkZ);
+        generator.Generate(scratch.voxels.data(), chunkX, chunkZ);
+        return HashContent(scratch.voxels.data(), CHUNK_VOXEL_COUNT * sizeof(VoxelType));
+    };
+
+    StageFunc cull = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        ChunkMesher::CullHidden(GetChunkVoxels(input, index), scratch.faces.data(),
+                                &input.aprons[index]);
+        return HashContent(scratch.faces.data(), scratch.faces.size());
+    };
+
+    StageFunc meshNaive = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        ChunkMesher::GenerateNaive(GetChunkVoxels(input, index), scratch.verts,
+                                   &input.aprons[index]);
+        return HashContent(scratch.verts.data(), scratch.verts.size() * sizeof(float));
+    };
+
+    StageFunc meshInstanced = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        ChunkMesher::GenerateInstanced(GetChunkVoxels(input, index), scratch.instances,
+                                       &input.aprons[index]);
+        return HashContent(scratch.instances.data(),
+                           scratch.instances.size() * sizeof(CubeInstance));
+    };
+
+    StageFunc meshGreedy = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        ChunkMesher::GenerateGreedy(GetChunkVoxels(input, index), scratch.packedVerts,
+                                    &input.aprons[index]);
+        return HashContent(scratch.packedVerts.data(),
+                           scratch.packedVerts.size() * sizeof(PackedVertex));
+    };
+
+    // Remeshing after an edit - a single section, around the surface in the middle of chunk
+    StageFunc meshSection = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        const VoxelType* voxels = GetChunkVoxels(input, index);
+        int y = CHUNK_Y - 1;
+        while (y > 0 && voxels[(CHUNK_X / 2 * CHUNK_Y + y) * CHUNK_Z + CHUNK_Z / 2] ==
+               VoxelType::Air)
+            y--;
+
+        ChunkMesher::GenerateGreedySection(voxels,
+                                           ChunkMesher::GetSectionIndex(CHUNK_X / 2, y,
+                                                                        CHUNK_Z / 2),
+                                           scratch.packedVerts, &input.aprons[index]);
+        return HashContent(scratch.packedVerts.data(),
+                           scratch.packedVerts.size() * sizeof(PackedVertex));
+    };
+
+    StageFunc serialize = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        ChunkSerializer::Serialize(GetChunkVoxels(input, index), ChunkCompression::LZ,
+                                   scratch.data);
+        return HashContent(scratch.data.data(), scratch.data.size());
+    };
+
+    StageFunc deserialize = [&](unsigned int index, PipelineScratch& scratch) -> uint64_t
+    {
+        if (!ChunkSerializer::Deserialize(input.data[index], scratch.voxels.data()))
+            return 0;
+        return HashContent(scratch.voxels.data(), CHUNK_VOXEL_COUNT * sizeof(VoxelType));
+    };
+
+    MeasureStage(desc, "Heightmap", heightmap);
+    uint64_t fillHash = MeasureStage(desc, "Fill", fill);
+    MeasureStage(desc, "Cull", cull);
+    MeasureStage(desc, "Mesh naive", meshNaive);
+    MeasureStage(desc, "Mesh instanced", meshInstanced);
+    MeasureStage(desc, "Mesh greedy", meshGreedy);
+    MeasureStage(desc, "Mesh greedy section", meshSection);
+    MeasureStage(desc, "Serialize", serialize);
+    uint64_t loadHash = MeasureStage(desc, "Deserialize", deserialize);
+
+    // Chunks should survive the round trip through serializer unchanged
+    if (loadHash != fillHash)
+        std::cout << "    Deserialized chunks differ from generated ones!" << std::endl;
+
+    // Size of produced meshes, which is what Renderer has to upload and draw, and amount of faces
+    // between chunks hidden thanks to neighbours' borders
+    std::vector<float> verts;
+    std::vector<PackedVertex> packedVerts;
+    std::vector<CubeInstance> instances;
+    std::vector<unsigned char> faces(CHUNK_VOXEL_COUNT);
+    std::vector<VoxelType> lodVoxels(CHUNK_VOXEL_COUNT);
+    size_t naiveVertexCount = 0;
+    size_t instanceCount = 0;
+    size_t instanceFaceCount = 0;
+    size_t greedyVertexCount = 0;
+    size_t lodVertexCount[ChunkMesher::LOD_LEVEL_COUNT] = { 0 };
+    size_t borderFacesCulled = 0;
+    for (unsigned int i = 0; i < desc.chunkCount; ++i)
+    {
+        ChunkMesher::GenerateNaive(GetChunkVoxels(input, i), verts, &input.aprons[i]);
+        naiveVertexCount += verts.size() / ChunkMesher::FLOAT_COUNT_PER_VERTEX_NAIVE;
+        ChunkMesher::GenerateInstanced(GetChunkVoxels(input, i), instances, &input.aprons[i]);
+        instanceCount += instances.size();
+        for (const CubeInstance& instance : instances)
+            for (unsigned char faceBits = instance.faces; faceBits; faceBits &= faceBits - 1)
+                instanceFaceCount++;
+        ChunkMesher::GenerateGreedy(GetChunkVoxels(input, i), packedVerts, &input.aprons[i]);
+        greedyVertexCount += packedVerts.size();
+
+        // Coarser levels are meshed without aprons, like in the game
+        for (unsigned int lod = 1; lod < ChunkMesher::LOD_LEVEL_COUNT; ++lod)
+        {
+            ChunkMesher::Downsample(GetChunkVoxels(input, i), lod, lodVoxels.data());
+            ChunkMesher::GenerateGreedy(lodVoxels.data(), packedVerts);
+            lodVertexCount[lod] += packedVerts.size();
+        }
+
+        ChunkMesher::CullHidden(GetChunkVoxels(input, i), faces.data());
+        borderFacesCulled += ChunkMesher::CountBorderFaces(faces.data());
+        ChunkMesher::CullHidden(GetChunkVoxels(input, i), faces.data(), &input.aprons[i]);
+        borderFacesCulled -= ChunkMesher::CountBorderFaces(faces.data());
+    }
+
+    ReportResult("Mesh naive points", static_cast<double>(naiveVertexCount) / desc.chunkCount,
+                 "per chunk");
+    // Geometry Shader emits all six faces of a point, instanced cube drops hidden ones
+    ReportResult("Mesh naive triangles", static_cast<double>(naiveVertexCount) * 12.0 /
+                 desc.chunkCount, "per chunk");
+    ReportResult("Mesh instanced triangles", static_cast<double>(instanceFaceCount) * 2.0 /
+                 desc.chunkCount, "per chunk");
+    ReportResult("Mesh greedy triangles",
+                 static_cast<double>(greedyVertexCount) / ChunkMesher::QUAD_VERTEX_COUNT * 2.0 /
+                 desc.chunkCount, "per chunk");
+    for (unsigned int lod = 1; lod < ChunkMesher::LOD_LEVEL_COUNT; ++lod)
+        ReportResult("Mesh greedy triangles LOD " + std::to_string(lod),
+                     static_cast<double>(lodVertexCount[lod]) / ChunkMesher::QUAD_VERTEX_COUNT *
+                     2.0 / desc.chunkCount, "per chunk");
+    ReportResult("Mesh naive size", static_cast<double>(naiveVertexCount) / desc.chunkCount *
+                 ChunkMesher::FLOAT_COUNT_PER_VERTEX_NAIVE * sizeof(float) / 1024.0, "KB/chunk");
+    ReportResult("Mesh instanced size", static_cast<double>(instanceCount) / desc.chunkCount *
+                 sizeof(CubeInstance) / 1024.0, "KB/chunk");
+    ReportResult("Mesh greedy size", static_cast<double>(greedyVertexCount) / desc.chunkCount *
+                 sizeof(PackedVertex) / 1024.0, "KB/chunk");
+    ReportResult("Mesh border faces culled",
+                 static_cast<double>(borderFacesCulled) / desc.chunkCount, "per chunk");
+}
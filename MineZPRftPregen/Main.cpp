@@ -0,0 +1,271 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Main function of world pregeneration tool
+ *
+ * Generates chunks of the game world and saves them to ChunkBank, without any window or OpenGL
+ * context. Game loads saved chunks instead of generating them, so the pregenerated area can be
+ * explored without waiting for terrain generation.
+ */
+
+#include "Common/Common.hpp"
+#include "Common/FileSystem.hpp"
+#include "Common/Logger.hpp"
+#include "Common/Timer.hpp"
+#include "Terrain/ChunkManifest.hpp"
+#include "Terrain/ChunkSerializer.hpp"
+#include "Terrain/TerrainGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_RADIUS = 16;
+const int MAX_RADIUS = 4096;
+const int MAX_CHUNK_COORD = 1 << 20;
+const int MAX_THREADS = 256;
+
+struct PregenDesc
+{
+    int minX, minZ;                 ///< First chunk of generated rectangle.
+    int maxX, maxZ;                 ///< Last chunk of generated rectangle, inclusive.
+    unsigned int threadCount;       ///< Amount of worker threads.
+    ChunkCompression compression;   ///< Compression of saved chunks.
+    bool overwrite;                 ///< Replace chunks which are already saved.
+};
+
+struct PregenStats
+{
+    std::atomic<size_t> generated;
+    std::atomic<size_t> skipped;
+    std::atomic<size_t> failed;
+    std::atomic<uint64_t> bytesWritten;
+};
+
+typedef std::pair<int, int> ChunkCoords;
+
+void PrintUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [--radius R | --rect X0 Z0 X1 Z1]"
+              << " [--threads N] [--compression rle|lz] [--overwrite]" << std::endl;
+    std::cout << "Generates chunks [-R, R] x [-R, R] (default R = " << DEFAULT_RADIUS
+              << ") or [X0, X1] x [Z0, Z1] into " << CHUNK_DIR << std::endl;
+    std::cout << "R is at most " << MAX_RADIUS << ", coordinates are within +-" << MAX_CHUNK_COORD
+              << " and N is at most " << MAX_THREADS << std::endl;
+}
+
+// Parse whole @p str as a decimal integer within [@p min, @p max]
+bool ParseInt(const char* str, int min, int max, int& result)
+{
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(str, &end, 10);
+    if (*str == '\0' || *end != '\0' || errno == ERANGE || value < min || value > max)
+        return false;
+
+    result = static_cast<int>(value);
+    return true;
+}
+
+bool WriteChunk(const std::string& fileName, const std::vector<unsigned char>& data)
+{
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        LOG_E("Failed to open file \"" << fileName << "\" for writing.");
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!file)
+    {
+        LOG_E("Writing to file \"" << fileName << "\" failed.");
+        return false;
+    }
+
+    return true;
+}
+
+// Generate and save chunks from @p chunks, picking them one by one until all are taken
+void PregenWorker(const PregenDesc& desc, const TerrainGenerator& generator,
+                  const ChunkManifest& manifest, const std::vector<ChunkCoords>& chunks,
+                  std::atomic<size_t>& nextChunk, PregenStats& stats)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    std::vector<DecorationWrite> writes;
+    std::vector<unsigned char> data;
+
+    for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+    {
+        int x = chunks[i].first;
+        int z = chunks[i].second;
+        std::string fileName(CHUNK_DIR + '/' + ChunkManifest::GetChunkFileName(x, z));
+
+        if (!desc.overwrite && manifest.MayContain(x, z) && std::ifstream(fileName).is_open())
+        {
+            stats.skipped++;
+            continue;
+        }
+
+        generator.Generate(voxels.data(), x, z);
+
+        // Game decorates loaded chunks again, giving them parts of neighbours' trees, so only
+        // decorations landing in this chunk are placed here
+        writes.clear();
+        generator.Decorate(voxels.data(), x, z, writes);
+        for (const auto& write : writes)
+            if (write.chunkX == x && write.chunkZ == z)
+                PlaceDecoration(voxels[write.index], write.voxel);
+
+        ChunkSerializer::Serialize(voxels.data(), desc.compression, data);
+        if (!WriteChunk(fileName, data))
+        {
+            stats.failed++;
+            continue;
+        }
+
+        stats.generated++;
+        stats.bytesWritten += data.size();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    PregenDesc desc;
+    desc.minX = desc.minZ = -DEFAULT_RADIUS;
+    desc.maxX = desc.maxZ = DEFAULT_RADIUS;
+    desc.threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    desc.compression = ChunkCompression::LZ;
+    desc.overwrite = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        int remaining = argc - i - 1;
+        int radius, threads;
+        if (remaining >= 1 && strcmp(argv[i], "--radius") == 0 &&
+            ParseInt(argv[i + 1], 0, MAX_RADIUS, radius))
+        {
+            desc.minX = desc.minZ = -radius;
+            desc.maxX = desc.maxZ = radius;
+            i++;
+        }
+        else if (remaining >= 4 && strcmp(argv[i], "--rect") == 0 &&
+                 ParseInt(argv[i + 1], -MAX_CHUNK_COORD, MAX_CHUNK_COORD, desc.minX) &&
+                 ParseInt(argv[i + 2], -MAX_CHUNK_COORD, MAX_CHUNK_COORD, desc.minZ) &&
+                 ParseInt(argv[i + 3], -MAX_CHUNK_COORD, MAX_CHUNK_COORD, desc.maxX) &&
+                 ParseInt(argv[i + 4], -MAX_CHUNK_COORD, MAX_CHUNK_COORD, desc.maxZ))
+            i += 4;
+        else if (remaining >= 1 && strcmp(argv[i], "--threads") == 0 &&
+                 ParseInt(argv[i + 1], 1, MAX_THREADS, threads))
+        {
+            desc.threadCount = static_cast<unsigned int>(threads);
+            i++;
+        }
+        else if (remaining >= 1 && strcmp(argv[i], "--compression") == 0 &&
+                 strcmp(argv[i + 1], "rle") == 0)
+        {
+            desc.compression = ChunkCompression::RLE;
+            i++;
+        }
+        else if (remaining >= 1 && strcmp(argv[i], "--compression") == 0 &&
+                 strcmp(argv[i + 1], "lz") == 0)
+        {
+            desc.compression = ChunkCompression::LZ;
+            i++;
+        }
+        else if (strcmp(argv[i], "--overwrite") == 0)
+            desc.overwrite = true;
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Rectangle is limited just like the radius, so the list of its chunks stays reasonable
+    if (desc.minX > desc.maxX || desc.minZ > desc.maxZ ||
+        desc.maxX - desc.minX > 2 * MAX_RADIUS || desc.maxZ - desc.minZ > 2 * MAX_RADIUS)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Work in project root directory, just like the game does
+    FS::ChangeDirectory(FS::GetExecutableDir() + "/../../..");
+    Logger::GetInstance().SetCurrentWorkingDir(FS::GetCurrentWorkingDir());
+
+    if (!FS::IsDir(CHUNK_DIR) && !FS::CreateDir(CHUNK_DIR))
+    {
+        std::cout << "Failed to create directory " << CHUNK_DIR << std::endl;
+        return 1;
+    }
+
+    ChunkManifest manifest;
+    manifest.Build(CHUNK_DIR);
+
+    TerrainGenerator generator;
+    generator.Init(GetWorldGeneratorDesc(WORLD_SEED));
+
+    // Closest chunks first, so interrupted run still covers the area around world's center
+    std::vector<ChunkCoords> chunks;
+    for (int x = desc.minX; x <= desc.maxX; ++x)
+        for (int z = desc.minZ; z <= desc.maxZ; ++z)
+            chunks.push_back(ChunkCoords(x, z));
+    std::stable_sort(chunks.begin(), chunks.end(), [](const ChunkCoords& a, const ChunkCoords& b)
+    {
+        return std::max(std::abs(a.first), std::abs(a.second)) <
+               std::max(std::abs(b.first), std::abs(b.second));
+    });
+
+    std::cout << "Generating " << chunks.size() << " chunks [" << desc.minX << ", " << desc.minZ
+              << "] - [" << desc.maxX << ", " << desc.maxZ << "], seed " << WORLD_SEED << ", "
+              << desc.threadCount << " threads" << std::endl;
+
+    PregenStats stats;
+    stats.generated = 0;
+    stats.skipped = 0;
+    stats.failed = 0;
+    stats.bytesWritten = 0;
+    std::atomic<size_t> nextChunk(0);
+
+    Timer timer;
+    timer.Start();
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < desc.threadCount; ++i)
+        workers.emplace_back(PregenWorker, std::cref(desc), std::cref(generator),
+                             std::cref(manifest), std::cref(chunks), std::ref(nextChunk),
+                             std::ref(stats));
+    for (auto& worker : workers)
+        worker.join();
+
+    double seconds = timer.Stop();
+    double megabytes = static_cast<double>(stats.bytesWritten) / (1024.0 * 1024.0);
+
+    std::cout << "Generated " << stats.generated << " chunks in " << seconds << " s ("
+              << stats.generated / seconds << " chunks/s, "
+              << stats.generated / seconds / desc.threadCount << " chunks/s per thread)"
+              << std::endl;
+    std::cout << "Written " << megabytes << " MB (" << megabytes / seconds << " MB/s)"
+              << std::endl;
+    if (stats.skipped > 0)
+        std::cout << "Skipped " << stats.skipped << " chunks already saved, use --overwrite "
+                  << "to replace them" << std::endl;
+    if (stats.failed > 0)
+    {
+        std::cout << "Failed to save " << stats.failed << " chunks" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,461 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk voxels and mesher tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Terrain/ChunkMesher.hpp"
+#include "Terrain/ChunkVoxels.hpp"
+#include "Terrain/TerrainGenerator.hpp"
+
+
+namespace {
+
+const size_t QUAD_VERTEX_COUNT = ChunkMesher::QUAD_VERTEX_COUNT;
+const size_t CUBE_FACE_COUNT = 6;
+
+// Heap allocations made by calling thread, counted by replaced operator new below
+thread_local size_t gAllocationCount = 0;
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    gAllocationCount++;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+// GCC pairs inlined free() with the allocation made by operator new and reports a mismatch,
+// although both replacements in this file use malloc and free
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+
+/**
+ * Voxels outside of the chunk should be neither read nor written.
+ */
+TEST(ChunkVoxels, Bounds)
+{
+    ChunkVoxels voxels;
+    ASSERT_EQ(VoxelType::Air, voxels.GetVoxel(0, 0, 0));
+
+    voxels.SetVoxel(CHUNK_X - 1, CHUNK_Y - 1, CHUNK_Z - 1, VoxelType::Stone);
+    ASSERT_EQ(VoxelType::Stone, voxels.GetVoxel(CHUNK_X - 1, CHUNK_Y - 1, CHUNK_Z - 1));
+    ASSERT_EQ(VoxelType::Stone, voxels.GetData()[CHUNK_VOXEL_COUNT - 1]);
+
+    voxels.SetVoxel(CHUNK_X, 0, 0, VoxelType::Stone);
+    voxels.SetVoxel(0, CHUNK_Y, 0, VoxelType::Stone);
+    voxels.SetVoxel(0, 0, CHUNK_Z, VoxelType::Stone);
+    ASSERT_EQ(VoxelType::Unknown, voxels.GetVoxel(CHUNK_X, 0, 0));
+    ASSERT_EQ(VoxelType::Unknown, voxels.GetVoxel(0, CHUNK_Y, 0));
+    ASSERT_EQ(VoxelType::Unknown, voxels.GetVoxel(0, 0, CHUNK_Z));
+
+    size_t solid = 0;
+    for (size_t i = 0; i < CHUNK_VOXEL_COUNT; ++i)
+        if (voxels.GetData()[i] != VoxelType::Air)
+            solid++;
+    ASSERT_EQ(1u, solid);
+}
+
+/**
+ * Empty chunk produces no vertices.
+ */
+TEST(ChunkMesher, Empty)
+{
+    ChunkVoxels voxels;
+    std::vector<float> verts(1, 0.0f);
+
+    ASSERT_EQ(0, ChunkMesher::CalculateMeshHeight(voxels.GetData()));
+
+    ChunkMesher::GenerateNaive(voxels.GetData(), verts);
+    ASSERT_TRUE(verts.empty());
+
+    std::vector<PackedVertex> packedVerts(1);
+    ChunkMesher::GenerateGreedy(voxels.GetData(), packedVerts);
+    ASSERT_TRUE(packedVerts.empty());
+}
+
+/**
+ * Single voxel becomes a single point in naive mesh and a cube of six quads in greedy mesh.
+ */
+TEST(ChunkMesher, SingleVoxel)
+{
+    ChunkVoxels voxels;
+    voxels.SetVoxel(3, 5, 7, VoxelType::Stone);
+    ASSERT_EQ(6, ChunkMesher::CalculateMeshHeight(voxels.GetData()));
+
+    std::vector<float> verts;
+    ChunkMesher::GenerateNaive(voxels.GetData(), verts);
+    ASSERT_EQ(static_cast<size_t>(ChunkMesher::FLOAT_COUNT_PER_VERTEX_NAIVE), verts.size());
+    ASSERT_EQ(3.0f, verts[0]);
+    ASSERT_EQ(5.0f, verts[1]);
+    ASSERT_EQ(7.0f, verts[2]);
+
+    std::vector<PackedVertex> packedVerts;
+    ChunkMesher::GenerateGreedy(voxels.GetData(), packedVerts);
+    ASSERT_EQ(CUBE_FACE_COUNT * QUAD_VERTEX_COUNT, packedVerts.size());
+
+    // Packed vertices are corners of the voxel, every face has its own normal
+    for (size_t i = 0; i < packedVerts.size(); ++i)
+    {
+        const PackedVertex& vert = packedVerts[i];
+        ASSERT_TRUE(vert.x == 3 || vert.x == 4);
+        ASSERT_TRUE(vert.y == 5 || vert.y == 6);
+        ASSERT_TRUE(vert.z == 7 || vert.z == 8);
+        ASSERT_EQ(i / QUAD_VERTEX_COUNT, vert.normal);
+        ASSERT_EQ(static_cast<VoxelUnderType>(VoxelType::Stone), vert.voxel);
+    }
+}
+
+/**
+ * Greedy mesher should merge faces in both directions of a slice, up to section's boundaries - a
+ * flat layer of voxels has a single quad on top and bottom of every section, and a single strip
+ * on every side of the chunk per section.
+ */
+TEST(ChunkMesher, GreedyMergesSlices)
+{
+    ChunkVoxels voxels;
+    for (size_t x = 0; x < CHUNK_X; ++x)
+        for (size_t z = 0; z < CHUNK_Z; ++z)
+            voxels.SetVoxel(x, 10, z, VoxelType::Stone);
+
+    std::vector<PackedVertex> verts;
+    ChunkMesher::GenerateGreedy(voxels.GetData(), verts);
+
+    const size_t sectionCount = ChunkMesher::SECTION_COUNT_X * ChunkMesher::SECTION_COUNT_Z;
+    const size_t sideCount = 2 * ChunkMesher::SECTION_COUNT_X + 2 * ChunkMesher::SECTION_COUNT_Z;
+    ASSERT_EQ((2 * sectionCount + sideCount) * QUAD_VERTEX_COUNT, verts.size());
+}
+
+/**
+ * Sections of a greedy mesh follow each other, and a single section meshed again gets exactly
+ * the same vertices.
+ */
+TEST(ChunkMesher, Sections)
+{
+    ASSERT_EQ(0, ChunkMesher::GetSectionIndex(0, 0, 0));
+    ASSERT_EQ(1, ChunkMesher::GetSectionIndex(0, 0, ChunkMesher::SECTION_SIZE));
+    ASSERT_EQ(static_cast<int>(ChunkMesher::SECTION_COUNT_Z),
+              ChunkMesher::GetSectionIndex(3, ChunkMesher::SECTION_SIZE + 3, 3));
+    ASSERT_EQ(ChunkMesher::SECTION_COUNT - 1,
+              ChunkMesher::GetSectionIndex(CHUNK_X - 1, CHUNK_Y - 1, CHUNK_Z - 1));
+
+    TerrainGenerator generator;
+    generator.Init(TerrainGeneratorDesc());
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    generator.Generate(voxels.data(), 0, 0);
+    ChunkApron apron;
+    ChunkMesher::BuildApron(voxels.data(), nullptr, nullptr, voxels.data(), apron);
+
+    std::vector<PackedVertex> verts;
+    SectionRange sections[ChunkMesher::SECTION_COUNT];
+    ChunkMesher::GenerateGreedy(voxels.data(), verts, &apron, sections);
+
+    size_t next = 0;
+    std::vector<PackedVertex> sectionVerts;
+    for (int i = 0; i < ChunkMesher::SECTION_COUNT; ++i)
+    {
+        ASSERT_EQ(next, sections[i].first);
+        next += sections[i].count;
+
+        ChunkMesher::GenerateGreedySection(voxels.data(), i, sectionVerts, &apron);
+        ASSERT_EQ(sections[i].count, sectionVerts.size());
+        ASSERT_TRUE(std::equal(sectionVerts.begin(), sectionVerts.end(),
+                               verts.begin() + sections[i].first,
+                               [](const PackedVertex& a, const PackedVertex& b)
+                               {
+                                   return std::memcmp(&a, &b, sizeof(PackedVertex)) == 0;
+                               }));
+    }
+
+    ASSERT_EQ(verts.size(), next);
+}
+
+/**
+ * Faces between two solid voxels are hidden, other faces of these voxels stay visible.
+ */
+TEST(ChunkMesher, HiddenFaces)
+{
+    ChunkVoxels voxels;
+    voxels.SetVoxel(3, 5, 7, VoxelType::Stone);
+    voxels.SetVoxel(4, 5, 7, VoxelType::Stone);
+
+    std::vector<unsigned char> faces(CHUNK_VOXEL_COUNT);
+    ASSERT_EQ(6, ChunkMesher::CullHidden(voxels.GetData(), faces.data()));
+
+    const unsigned char allFaces = ChunkMesher::FACE_X_PLUS | ChunkMesher::FACE_X_MINUS |
+                                   ChunkMesher::FACE_Y_PLUS | ChunkMesher::FACE_Y_MINUS |
+                                   ChunkMesher::FACE_Z_PLUS | ChunkMesher::FACE_Z_MINUS;
+    const size_t first = 3 * CHUNK_Y * CHUNK_Z + 5 * CHUNK_Z + 7;
+    const size_t second = 4 * CHUNK_Y * CHUNK_Z + 5 * CHUNK_Z + 7;
+    ASSERT_EQ(allFaces & ~ChunkMesher::FACE_X_PLUS, faces[first]);
+    ASSERT_EQ(allFaces & ~ChunkMesher::FACE_X_MINUS, faces[second]);
+    ASSERT_EQ(0, faces[first - 1]);
+
+    // Both voxels together look like a single box, with faces merged along x
+    std::vector<PackedVertex> verts;
+    ChunkMesher::GenerateGreedy(voxels.GetData(), verts);
+    ASSERT_EQ(CUBE_FACE_COUNT * QUAD_VERTEX_COUNT, verts.size());
+
+    // Voxel buried inside a solid block has no visible faces at all
+    for (size_t x = 2; x <= 4; ++x)
+        for (size_t y = 4; y <= 6; ++y)
+            for (size_t z = 6; z <= 8; ++z)
+                voxels.SetVoxel(x, y, z, VoxelType::Stone);
+    ChunkMesher::CullHidden(voxels.GetData(), faces.data());
+    ASSERT_EQ(0, faces[first]);
+}
+
+/**
+ * Instanced mesh keeps the same voxels as naive mesh, along with their visible faces.
+ */
+TEST(ChunkMesher, Instanced)
+{
+    ChunkVoxels voxels;
+    voxels.SetVoxel(3, 5, 7, VoxelType::Stone);
+    voxels.SetVoxel(4, 5, 7, VoxelType::Grass);
+
+    std::vector<CubeInstance> instances(1);
+    ChunkMesher::GenerateInstanced(ChunkVoxels().GetData(), instances);
+    ASSERT_TRUE(instances.empty());
+
+    ChunkMesher::GenerateInstanced(voxels.GetData(), instances);
+    ASSERT_EQ(2u, instances.size());
+    ASSERT_EQ(3, instances[0].x);
+    ASSERT_EQ(4, instances[1].x);
+    for (const auto& instance : instances)
+    {
+        ASSERT_EQ(5, instance.y);
+        ASSERT_EQ(7, instance.z);
+        ASSERT_EQ(0, instance.reserved[0] | instance.reserved[1] | instance.reserved[2]);
+    }
+
+    std::vector<unsigned char> faces(CHUNK_VOXEL_COUNT);
+    ChunkMesher::CullHidden(voxels.GetData(), faces.data());
+    const size_t first = 3 * CHUNK_Y * CHUNK_Z + 5 * CHUNK_Z + 7;
+    const size_t second = 4 * CHUNK_Y * CHUNK_Z + 5 * CHUNK_Z + 7;
+    ASSERT_EQ(faces[first], instances[0].faces);
+    ASSERT_EQ(faces[second], instances[1].faces);
+    ASSERT_EQ(static_cast<VoxelUnderType>(VoxelType::Stone), instances[0].voxel);
+    ASSERT_EQ(static_cast<VoxelUnderType>(VoxelType::Grass), instances[1].voxel);
+
+    // Same voxels as in naive mesh, on real terrain
+    TerrainGenerator generator;
+    generator.Init(TerrainGeneratorDesc());
+    std::vector<VoxelType> terrain(CHUNK_VOXEL_COUNT);
+    generator.Generate(terrain.data(), 0, 0);
+
+    std::vector<float> verts;
+    ChunkMesher::GenerateNaive(terrain.data(), verts);
+    ChunkMesher::GenerateInstanced(terrain.data(), instances);
+    ASSERT_EQ(verts.size() / ChunkMesher::FLOAT_COUNT_PER_VERTEX_NAIVE, instances.size());
+}
+
+/**
+ * Solid voxels of neighbouring chunks hide faces on chunk's border, missing neighbours do not.
+ */
+TEST(ChunkMesher, ApronHidesBorderFaces)
+{
+    ChunkVoxels voxels;
+    for (size_t x = 0; x < CHUNK_X; ++x)
+        for (size_t z = 0; z < CHUNK_Z; ++z)
+            voxels.SetVoxel(x, 10, z, VoxelType::Stone);
+
+    // Same layer continues in the neighbours on X sides and in chunk [X, Z + 1]
+    ChunkApron apron;
+    ChunkMesher::BuildApron(voxels.GetData(), voxels.GetData(), voxels.GetData(), nullptr, apron);
+    ASSERT_EQ(VoxelType::Stone, apron.xPlus[10 * CHUNK_Z + 3]);
+    ASSERT_EQ(VoxelType::Air, apron.xPlus[11 * CHUNK_Z + 3]);
+    ASSERT_EQ(VoxelType::Stone, apron.zPlus[3 * CHUNK_Y + 10]);
+    ASSERT_EQ(VoxelType::Unknown, apron.zMinus[3 * CHUNK_Y + 10]);
+
+    std::vector<unsigned char> faces(CHUNK_VOXEL_COUNT);
+    ChunkMesher::CullHidden(voxels.GetData(), faces.data());
+    ASSERT_EQ(2 * CHUNK_X + 2 * CHUNK_Z, ChunkMesher::CountBorderFaces(faces.data()));
+    ChunkMesher::CullHidden(voxels.GetData(), faces.data(), &apron);
+    ASSERT_EQ(static_cast<size_t>(CHUNK_X), ChunkMesher::CountBorderFaces(faces.data()));
+
+    // Only top, bottom and the strip facing missing neighbour are left, split into sections
+    const size_t sectionCount = ChunkMesher::SECTION_COUNT_X * ChunkMesher::SECTION_COUNT_Z;
+    std::vector<PackedVertex> verts;
+    ChunkMesher::GenerateGreedy(voxels.GetData(), verts, &apron);
+    ASSERT_EQ((2 * sectionCount + ChunkMesher::SECTION_COUNT_X) * QUAD_VERTEX_COUNT,
+              verts.size());
+}
+
+/**
+ * Blocks of coarsened voxels are solid when at least half of their voxels are, and show their
+ * topmost voxel. Coarser meshes of real terrain have fewer quads.
+ */
+TEST(ChunkMesher, Downsample)
+{
+    ChunkVoxels voxels;
+    for (size_t x = 0; x < 2; ++x)
+        for (size_t z = 0; z < 2; ++z)
+        {
+            voxels.SetVoxel(x, 0, z, VoxelType::Stone);
+            voxels.SetVoxel(x + 2, 0, z, VoxelType::Stone);
+        }
+    voxels.SetVoxel(0, 1, 0, VoxelType::Grass);
+    voxels.SetVoxel(3, 1, 0, VoxelType::Grass);
+    voxels.SetVoxel(2, 0, 0, VoxelType::Air);
+
+    // First block has 5 of 8 voxels solid, second one exactly half
+    std::vector<VoxelType> result(CHUNK_VOXEL_COUNT);
+    ChunkMesher::Downsample(voxels.GetData(), 1, result.data());
+    ChunkVoxels coarse;
+    std::copy(result.begin(), result.end(), coarse.GetData());
+    for (size_t x = 0; x < 2; ++x)
+        for (size_t y = 0; y < 2; ++y)
+            for (size_t z = 0; z < 2; ++z)
+            {
+                ASSERT_EQ(VoxelType::Grass, coarse.GetVoxel(x, y, z));
+                ASSERT_EQ(VoxelType::Grass, coarse.GetVoxel(x + 2, y, z));
+            }
+
+    // Quarter resolution - 9 of 64 voxels are solid
+    ChunkMesher::Downsample(voxels.GetData(), 2, result.data());
+    ASSERT_TRUE(std::all_of(result.begin(), result.end(),
+                            [](VoxelType v) { return v == VoxelType::Air; }));
+
+    // Level 0 changes nothing
+    ChunkMesher::Downsample(voxels.GetData(), 0, result.data());
+    ASSERT_TRUE(std::equal(result.begin(), result.end(), voxels.GetData()));
+
+    TerrainGenerator generator;
+    generator.Init(TerrainGeneratorDesc());
+    std::vector<VoxelType> terrain(CHUNK_VOXEL_COUNT);
+    generator.Generate(terrain.data(), 0, 0);
+
+    std::vector<PackedVertex> verts;
+    ChunkMesher::GenerateGreedy(terrain.data(), verts);
+    size_t previousCount = verts.size();
+    for (unsigned int lod = 1; lod < ChunkMesher::LOD_LEVEL_COUNT; ++lod)
+    {
+        ChunkMesher::Downsample(terrain.data(), lod, result.data());
+        ChunkMesher::GenerateGreedy(result.data(), verts);
+        ASSERT_LT(verts.size(), previousCount);
+        previousCount = verts.size();
+    }
+}
+
+/**
+ * Every quad is split into two triangles using its own four vertices.
+ */
+TEST(ChunkMesher, QuadIndices)
+{
+    std::vector<unsigned int> indices(1, 0);
+    ChunkMesher::GenerateQuadIndices(0, indices);
+    ASSERT_TRUE(indices.empty());
+
+    ChunkMesher::GenerateQuadIndices(3, indices);
+    ASSERT_EQ(3u * ChunkMesher::QUAD_INDEX_COUNT, indices.size());
+
+    const unsigned int expected[] = { 8, 9, 10, 10, 9, 11 };
+    for (size_t i = 0; i < ChunkMesher::QUAD_INDEX_COUNT; ++i)
+        ASSERT_EQ(expected[i], indices[2 * ChunkMesher::QUAD_INDEX_COUNT + i]);
+}
+
+/**
+ * Shared cube is a single voxel of greedy mesh, split into triangles. All its triangles are
+ * wound the same way, when seen from outside.
+ */
+TEST(ChunkMesher, Cube)
+{
+    std::vector<PackedVertex> verts(1);
+    ChunkMesher::GenerateCube(verts);
+    ASSERT_EQ(static_cast<size_t>(ChunkMesher::CUBE_VERTEX_COUNT), verts.size());
+
+    // Y normals point inside the voxel, see ChunkMesher::GenerateGreedy()
+    const int outwards[6][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+
+    int winding = 0;
+    for (size_t i = 0; i < verts.size(); i += 3)
+    {
+        const PackedVertex* tri = &verts[i];
+        ASSERT_EQ(tri[0].normal, tri[1].normal);
+        ASSERT_EQ(tri[0].normal, tri[2].normal);
+        ASSERT_GT(6, tri[0].normal);
+
+        int a[3] = { tri[1].x - tri[0].x, tri[1].y - tri[0].y, tri[1].z - tri[0].z };
+        int b[3] = { tri[2].x - tri[0].x, tri[2].y - tri[0].y, tri[2].z - tri[0].z };
+        int cross[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+                         a[0] * b[1] - a[1] * b[0] };
+        const int* outward = outwards[tri[0].normal];
+        int side = cross[0] * outward[0] + cross[1] * outward[1] + cross[2] * outward[2];
+        ASSERT_NE(0, side);
+        if (winding == 0)
+            winding = side;
+        ASSERT_EQ(winding > 0, side > 0);
+
+        for (int v = 0; v < 3; ++v)
+        {
+            ASSERT_GE(1, tri[v].x);
+            ASSERT_GE(1, tri[v].y);
+            ASSERT_GE(1, tri[v].z);
+            ASSERT_EQ(0, tri[v].voxel);
+        }
+    }
+}
+
+/**
+ * Once scratch memory and output vectors have grown, meshing more chunks touches no heap memory.
+ */
+TEST(ChunkMesher, NoSteadyStateAllocations)
+{
+    TerrainGenerator generator;
+    generator.Init(TerrainGeneratorDesc());
+
+    std::vector<VoxelType> first(CHUNK_VOXEL_COUNT);
+    std::vector<VoxelType> second(CHUNK_VOXEL_COUNT);
+    generator.Generate(first.data(), 0, 0);
+    generator.Generate(second.data(), 1, 0);
+
+    ChunkApron& apron = ChunkMesher::GetThreadScratch().apron;
+    std::vector<float> verts;
+    std::vector<PackedVertex> packedVerts;
+    std::vector<CubeInstance> instances;
+    auto meshBoth = [&]()
+    {
+        ChunkMesher::BuildApron(second.data(), nullptr, nullptr, nullptr, apron);
+        ChunkMesher::GenerateNaive(first.data(), verts, &apron);
+        ChunkMesher::GenerateInstanced(first.data(), instances, &apron);
+        ChunkMesher::GenerateGreedy(first.data(), packedVerts, &apron);
+        ChunkMesher::BuildApron(nullptr, first.data(), nullptr, nullptr, apron);
+        ChunkMesher::GenerateNaive(second.data(), verts, &apron);
+        ChunkMesher::GenerateInstanced(second.data(), instances, &apron);
+        ChunkMesher::GenerateGreedy(second.data(), packedVerts, &apron);
+    };
+
+    // Warm up, so all buffers fit the larger of both chunks
+    size_t allocationCount = gAllocationCount;
+    meshBoth();
+    ASSERT_FALSE(packedVerts.empty());
+    ASSERT_LT(allocationCount, gAllocationCount);
+
+    allocationCount = gAllocationCount;
+    for (int i = 0; i < 3; ++i)
+        meshBoth();
+    ASSERT_EQ(allocationCount, gAllocationCount);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Compression and Chunk Serializer tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Common/Compression.hpp"
+#include "Terrain/ChunkSerializer.hpp"
+
+
+namespace {
+
+// Build a chunk resembling generated terrain - bedrock, stone up to varying height, air above
+std::vector<VoxelType> CreateTerrainChunk()
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+    for (int x = 0; x < CHUNK_X; ++x)
+        for (int z = 0; z < CHUNK_Z; ++z)
+        {
+            int height = CHUNK_Y / 4 + (x * 7 + z * 3) % HEIGHTMAP_HEIGHT;
+            for (int y = 0; y < height; ++y)
+                voxels[x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z] =
+                    (y < 2) ? VoxelType::Bedrock : VoxelType::Stone;
+        }
+
+    return voxels;
+}
+
+void LZRoundTrip(const std::vector<unsigned char>& input)
+{
+    std::vector<unsigned char> compressed;
+    Compression::LZCompress(input.data(), input.size(), compressed);
+
+    std::vector<unsigned char> output(input.size());
+    ASSERT_TRUE(Compression::LZDecompress(compressed.data(), compressed.size(),
+                                          output.data(), output.size()));
+    ASSERT_EQ(input, output);
+}
+
+} // namespace
+
+
+/**
+ * Data of various shapes should survive compression unchanged.
+ */
+TEST(Compression, LZRoundTrip)
+{
+    LZRoundTrip({});
+    LZRoundTrip({1, 2, 3});
+
+    // Long runs produce overlapping matches and extended lengths
+    LZRoundTrip(std::vector<unsigned char>(10000, 7));
+
+    // Pseudo-random, mostly incompressible data
+    std::vector<unsigned char> noise(5000);
+    uint32_t state = 12345;
+    for (auto& byte : noise)
+    {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<unsigned char>(state >> 16);
+    }
+    LZRoundTrip(noise);
+
+    // Repeating pattern with period longer than minimal match
+    std::vector<unsigned char> pattern;
+    for (int i = 0; i < 4000; ++i)
+        pattern.push_back(static_cast<unsigned char>(i % 37));
+    LZRoundTrip(pattern);
+}
+
+/**
+ * Repetitive data should actually get smaller.
+ */
+TEST(Compression, LZCompresses)
+{
+    std::vector<unsigned char> input(10000, 0);
+    std::vector<unsigned char> compressed;
+    Compression::LZCompress(input.data(), input.size(), compressed);
+    ASSERT_LT(compressed.size(), input.size() / 100);
+}
+
+/**
+ * Decompressor must reject streams that are truncated or decompress to a different size.
+ */
+TEST(Compression, LZCorruptedInput)
+{
+    std::vector<unsigned char> input(1000, 3);
+    std::vector<unsigned char> compressed;
+    Compression::LZCompress(input.data(), input.size(), compressed);
+
+    std::vector<unsigned char> output(input.size());
+    ASSERT_FALSE(Compression::LZDecompress(compressed.data(), compressed.size() - 1,
+                                           output.data(), output.size()));
+    ASSERT_FALSE(Compression::LZDecompress(compressed.data(), compressed.size(),
+                                           output.data(), output.size() - 1));
+
+    // Back-reference pointing before the beginning of output
+    const unsigned char badOffset[] = {0x10, 0xAA, 0x05, 0x00};
+    ASSERT_FALSE(Compression::LZDecompress(badOffset, sizeof(badOffset),
+                                           output.data(), output.size()));
+}
+
+/**
+ * Chunk serialized with each compression method should deserialize to the same voxels.
+ */
+TEST(ChunkSerializer, RoundTrip)
+{
+    std::vector<VoxelType> voxels = CreateTerrainChunk();
+    std::vector<unsigned char> data;
+    std::vector<VoxelType> decoded(CHUNK_VOXEL_COUNT);
+
+    for (ChunkCompression compression : {ChunkCompression::RLE, ChunkCompression::LZ})
+    {
+        ChunkSerializer::Serialize(voxels.data(), compression, data);
+        ASSERT_LT(data.size(), static_cast<size_t>(CHUNK_VOXEL_COUNT / 10));
+        ASSERT_TRUE(ChunkSerializer::Deserialize(data, decoded.data()));
+        ASSERT_EQ(voxels, decoded);
+    }
+}
+
+/**
+ * LZ compression on top of RLE should improve ratio for terrain-like chunks.
+ */
+TEST(ChunkSerializer, LZImprovesRatio)
+{
+    std::vector<VoxelType> voxels = CreateTerrainChunk();
+    std::vector<unsigned char> rle, lz;
+
+    ChunkSerializer::Serialize(voxels.data(), ChunkCompression::RLE, rle);
+    ChunkSerializer::Serialize(voxels.data(), ChunkCompression::LZ, lz);
+    ASSERT_LT(lz.size(), rle.size());
+}
+
+/**
+ * Chunks saved in legacy text format should still be readable.
+ */
+TEST(ChunkSerializer, LegacyFormat)
+{
+    // Whole chunk is made of two runs - bedrock followed by air
+    const int bedrockCount = CHUNK_Y * CHUNK_Z;
+    std::string legacy = std::to_string(bedrockCount) +
+                         static_cast<char>(VoxelType::Bedrock) +
+                         std::to_string(CHUNK_VOXEL_COUNT - bedrockCount) +
+                         static_cast<char>(VoxelType::Air);
+
+    std::vector<unsigned char> data(legacy.begin(), legacy.end());
+    std::vector<VoxelType> decoded(CHUNK_VOXEL_COUNT);
+    ASSERT_TRUE(ChunkSerializer::Deserialize(data, decoded.data()));
+
+    for (int i = 0; i < CHUNK_VOXEL_COUNT; ++i)
+        ASSERT_EQ(i < bedrockCount ? VoxelType::Bedrock : VoxelType::Air, decoded[i]);
+}
+
+/**
+ * Corrupted payload must be detected.
+ */
+TEST(ChunkSerializer, CorruptedData)
+{
+    std::vector<VoxelType> voxels = CreateTerrainChunk();
+    std::vector<unsigned char> data;
+    std::vector<VoxelType> decoded(CHUNK_VOXEL_COUNT);
+
+    ChunkSerializer::Serialize(voxels.data(), ChunkCompression::RLE, data);
+    data.resize(data.size() - 3);
+    ASSERT_FALSE(ChunkSerializer::Deserialize(data, decoded.data()));
+}
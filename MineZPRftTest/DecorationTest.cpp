@@ -0,0 +1,205 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain decoration tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "Terrain/Decoration.hpp"
+#include "Terrain/TerrainGenerator.hpp"
+
+
+namespace {
+
+// Chunks searched for trees reaching into neighbours
+const int SEARCH_RADIUS = 8;
+
+typedef std::pair<int, int> ChunkKey;
+typedef std::map<ChunkKey, std::vector<VoxelType>> ChunkMap;
+
+TerrainGeneratorDesc GetDecoratedDesc()
+{
+    TerrainGeneratorDesc desc;
+    desc.biomes = true;
+    desc.decorations = true;
+    return desc;
+}
+
+// Generate 3x3 chunks around [centerX, centerZ], without attaching them anywhere
+ChunkMap GenerateBlock(const TerrainGenerator& generator, int centerX, int centerZ)
+{
+    ChunkMap chunks;
+    for (int x = centerX - 1; x <= centerX + 1; ++x)
+        for (int z = centerZ - 1; z <= centerZ + 1; ++z)
+        {
+            std::vector<VoxelType>& voxels = chunks[ChunkKey(x, z)];
+            voxels.resize(CHUNK_VOXEL_COUNT);
+            generator.Generate(voxels.data(), x, z);
+        }
+
+    return chunks;
+}
+
+// Find a chunk, which has a tree reaching into one of its neighbours
+bool FindBorderTree(const TerrainGenerator& generator, int& chunkX, int& chunkZ)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    std::vector<DecorationWrite> writes;
+
+    for (chunkX = -SEARCH_RADIUS; chunkX <= SEARCH_RADIUS; ++chunkX)
+        for (chunkZ = -SEARCH_RADIUS; chunkZ <= SEARCH_RADIUS; ++chunkZ)
+        {
+            generator.Generate(voxels.data(), chunkX, chunkZ);
+            writes.clear();
+            generator.Decorate(voxels.data(), chunkX, chunkZ, writes);
+
+            for (const auto& write : writes)
+                if (write.chunkX != chunkX || write.chunkZ != chunkZ)
+                    return true;
+        }
+
+    return false;
+}
+
+} // namespace
+
+
+/**
+ * Decorations should grow only on grass and should never replace terrain.
+ */
+TEST(Decoration, OnlyOverAir)
+{
+    TerrainGenerator generator;
+    generator.Init(GetDecoratedDesc());
+
+    int centerX, centerZ;
+    ASSERT_TRUE(FindBorderTree(generator, centerX, centerZ));
+
+    ChunkMap terrain = GenerateBlock(generator, centerX, centerZ);
+    ChunkMap decorated = terrain;
+
+    DecorationQueue queue;
+    for (auto& chunk : decorated)
+        queue.Attach(chunk.first.first, chunk.first.second, chunk.second.data());
+    ASSERT_TRUE(queue.Decorate(generator, centerX, centerZ));
+
+    size_t placed = 0;
+    for (const auto& chunk : decorated)
+    {
+        const std::vector<VoxelType>& before = terrain[chunk.first];
+        for (size_t i = 0; i < CHUNK_VOXEL_COUNT; ++i)
+        {
+            if (before[i] == chunk.second[i])
+                continue;
+
+            ASSERT_EQ(VoxelType::Air, before[i]);
+            ASSERT_TRUE(chunk.second[i] == VoxelType::Wood || chunk.second[i] == VoxelType::Leaves);
+            placed++;
+        }
+    }
+
+    ASSERT_LT(0u, placed);
+    ASSERT_EQ(0u, queue.GetPendingCount());
+}
+
+/**
+ * Final voxels must not depend on the order in which chunks are attached and decorated, nor on
+ * whether a write had to wait in the queue for its chunk.
+ */
+TEST(Decoration, OrderIndependent)
+{
+    TerrainGenerator generator;
+    generator.Init(GetDecoratedDesc());
+
+    int centerX, centerZ;
+    ASSERT_TRUE(FindBorderTree(generator, centerX, centerZ));
+
+    // Reference - all chunks are attached before any of them is decorated
+    ChunkMap reference = GenerateBlock(generator, centerX, centerZ);
+    {
+        DecorationQueue queue;
+        for (auto& chunk : reference)
+            queue.Attach(chunk.first.first, chunk.first.second, chunk.second.data());
+        for (const auto& chunk : reference)
+            queue.Decorate(generator, chunk.first.first, chunk.first.second);
+    }
+
+    // Reversed - decorate every chunk right after attaching it, in reverse order. Writes into
+    // chunks attached later have to wait in the queue.
+    ChunkMap reversed = GenerateBlock(generator, centerX, centerZ);
+    {
+        DecorationQueue queue;
+        size_t maxPending = 0;
+        for (auto chunk = reversed.rbegin(); chunk != reversed.rend(); ++chunk)
+        {
+            queue.Attach(chunk->first.first, chunk->first.second, chunk->second.data());
+            queue.Decorate(generator, chunk->first.first, chunk->first.second);
+            maxPending = std::max(maxPending, queue.GetPendingCount());
+        }
+
+        ASSERT_LT(0u, maxPending);
+    }
+
+    // Only the center chunk received decorations from all its neighbours
+    ChunkKey center(centerX, centerZ);
+    ASSERT_EQ(reference[center], reversed[center]);
+}
+
+/**
+ * Decorating a chunk again (ex. after it was loaded from disk) should change nothing.
+ */
+TEST(Decoration, Idempotent)
+{
+    TerrainGenerator generator;
+    generator.Init(GetDecoratedDesc());
+
+    int centerX, centerZ;
+    ASSERT_TRUE(FindBorderTree(generator, centerX, centerZ));
+
+    ChunkMap chunks = GenerateBlock(generator, centerX, centerZ);
+    DecorationQueue queue;
+    for (auto& chunk : chunks)
+        queue.Attach(chunk.first.first, chunk.first.second, chunk.second.data());
+    for (const auto& chunk : chunks)
+        queue.Decorate(generator, chunk.first.first, chunk.first.second);
+
+    ChunkMap decorated = chunks;
+    for (const auto& chunk : chunks)
+        queue.Decorate(generator, chunk.first.first, chunk.first.second);
+
+    ASSERT_EQ(decorated, chunks);
+}
+
+/**
+ * Writes to chunks which were never attached stay in the queue, decorating a chunk which is not
+ * attached does nothing.
+ */
+TEST(Decoration, Pending)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+    DecorationQueue queue;
+
+    std::vector<DecorationWrite> writes;
+    writes.push_back({ 0, 0, 5, VoxelType::Leaves });
+    writes.push_back({ 0, 0, 5, VoxelType::Wood });
+    writes.push_back({ 0, 0, 6, VoxelType::Wood });
+    writes.push_back({ 0, 0, 6, VoxelType::Leaves });
+    writes.push_back({ 1, 0, 7, VoxelType::Wood });
+    queue.Submit(writes);
+    ASSERT_EQ(5u, queue.GetPendingCount());
+
+    queue.Attach(0, 0, voxels.data());
+    ASSERT_EQ(1u, queue.GetPendingCount());
+    ASSERT_EQ(VoxelType::Wood, voxels[5]);
+    ASSERT_EQ(VoxelType::Wood, voxels[6]);
+    ASSERT_EQ(VoxelType::Air, voxels[7]);
+
+    TerrainGenerator generator;
+    generator.Init(GetDecoratedDesc());
+    ASSERT_FALSE(queue.Decorate(generator, 2, 0));
+}
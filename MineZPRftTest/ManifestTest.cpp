@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Chunk Manifest tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "Terrain/ChunkManifest.hpp"
+#include "Common/FileSystem.hpp"
+
+
+namespace {
+
+const int TEST_RADIUS = 30;
+const std::string TEST_DIR = "ManifestTestDir";
+
+} // namespace
+
+
+/**
+ * Chunk file names should survive a round trip, including negative coordinates.
+ */
+TEST(ChunkManifest, FileNames)
+{
+    int x, z;
+
+    ASSERT_TRUE(ChunkManifest::ParseChunkFileName(ChunkManifest::GetChunkFileName(3, 7), x, z));
+    ASSERT_EQ(3, x);
+    ASSERT_EQ(7, z);
+
+    ASSERT_TRUE(ChunkManifest::ParseChunkFileName(ChunkManifest::GetChunkFileName(-12, -1), x, z));
+    ASSERT_EQ(-12, x);
+    ASSERT_EQ(-1, z);
+
+    ASSERT_FALSE(ChunkManifest::ParseChunkFileName("Chunk_1_2.txt", x, z));
+    ASSERT_FALSE(ChunkManifest::ParseChunkFileName("Chunk_1.riQrll", x, z));
+    ASSERT_FALSE(ChunkManifest::ParseChunkFileName("Chunk_a_2.riQrll", x, z));
+    ASSERT_FALSE(ChunkManifest::ParseChunkFileName("Something", x, z));
+}
+
+/**
+ * Every added chunk must be reported, there can be no false negatives.
+ */
+TEST(ChunkManifest, NoFalseNegatives)
+{
+    ChunkManifest manifest;
+
+    for (int x = -TEST_RADIUS; x <= TEST_RADIUS; ++x)
+        for (int z = -TEST_RADIUS; z <= TEST_RADIUS; ++z)
+            manifest.Add(x, z);
+
+    for (int x = -TEST_RADIUS; x <= TEST_RADIUS; ++x)
+        for (int z = -TEST_RADIUS; z <= TEST_RADIUS; ++z)
+            ASSERT_TRUE(manifest.MayContain(x, z));
+
+    ASSERT_EQ(static_cast<size_t>((2 * TEST_RADIUS + 1) * (2 * TEST_RADIUS + 1)),
+              manifest.GetEntryCount());
+}
+
+/**
+ * Chunks which were not added should be rejected in vast majority of cases.
+ */
+TEST(ChunkManifest, FalsePositiveRate)
+{
+    ChunkManifest manifest;
+
+    for (int x = -TEST_RADIUS; x <= TEST_RADIUS; ++x)
+        for (int z = -TEST_RADIUS; z <= TEST_RADIUS; ++z)
+            manifest.Add(x, z);
+
+    // Probe a ring of the same size right next to the added area
+    int falsePositives = 0;
+    int probes = 0;
+    for (int x = TEST_RADIUS + 1; x <= 3 * TEST_RADIUS + 1; ++x)
+        for (int z = -TEST_RADIUS; z <= TEST_RADIUS; ++z)
+        {
+            probes++;
+            if (manifest.MayContain(x, z))
+                falsePositives++;
+        }
+
+    // ~3700 entries in a 64k-bit filter should stay well under 2% false positives
+    ASSERT_LT(falsePositives * 50, probes);
+}
+
+/**
+ * Clearing the manifest should remove all entries.
+ */
+TEST(ChunkManifest, Clear)
+{
+    ChunkManifest manifest;
+    manifest.Add(1, 2);
+    ASSERT_TRUE(manifest.MayContain(1, 2));
+
+    manifest.Clear();
+    ASSERT_FALSE(manifest.MayContain(1, 2));
+    ASSERT_EQ(0u, manifest.GetEntryCount());
+}
+
+/**
+ * Build manifest from a directory containing chunk files and some unrelated ones.
+ */
+TEST(ChunkManifest, BuildFromDirectory)
+{
+    if (!FS::IsDir(TEST_DIR))
+    {
+        ASSERT_TRUE(FS::CreateDir(TEST_DIR));
+    }
+
+    const std::string files[] = {
+        ChunkManifest::GetChunkFileName(0, 0),
+        ChunkManifest::GetChunkFileName(-5, 3),
+        "NotAChunk.txt",
+    };
+
+    for (const auto& file : files)
+        std::ofstream(TEST_DIR + '/' + file) << "test";
+
+    ChunkManifest manifest;
+    manifest.Build(TEST_DIR);
+
+    for (const auto& file : files)
+        std::remove((TEST_DIR + '/' + file).c_str());
+    std::remove(TEST_DIR.c_str());
+
+    ASSERT_EQ(2u, manifest.GetEntryCount());
+    ASSERT_TRUE(manifest.MayContain(0, 0));
+    ASSERT_TRUE(manifest.MayContain(-5, 3));
+    ASSERT_FALSE(manifest.MayContain(1, 1));
+
+    // Nonexistent directory results in an empty manifest
+    manifest.Build(TEST_DIR + "/DoesNotExist");
+    ASSERT_EQ(0u, manifest.GetEntryCount());
+}
@@ -0,0 +1,393 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Noise Generator and Fractal Noise tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Terrain/NoiseGenerator.hpp"
+#include "Terrain/FractalNoise.hpp"
+#include "Terrain/Defines.hpp"
+
+
+namespace {
+
+const size_t TEST_POINT_COUNT = 1003; // not a multiple of vector width, to cover the tail
+const float TEST_TOLERANCE = 1e-4f;
+
+void GenerateTestPoints(std::vector<float>& xs, std::vector<float>& ys, std::vector<float>& zs)
+{
+    std::default_random_engine engine(1234);
+    std::uniform_real_distribution<float> distribution(-300.0f, 300.0f);
+
+    xs.resize(TEST_POINT_COUNT);
+    ys.resize(TEST_POINT_COUNT);
+    zs.resize(TEST_POINT_COUNT);
+    for (size_t i = 0; i < TEST_POINT_COUNT; ++i)
+    {
+        xs[i] = distribution(engine);
+        ys[i] = distribution(engine);
+        zs[i] = distribution(engine);
+    }
+
+    // Points lying exactly on lattice, where all gradients contribute zero
+    xs[0] = 0.0f; ys[0] = 0.0f; zs[0] = 0.0f;
+    xs[1] = -1.0f; ys[1] = 255.0f; zs[1] = 256.0f;
+}
+
+void CheckBatch(NoiseSIMD simd, NoiseBackend backend = NoiseBackend::Permutation,
+                uint32_t seed = 0)
+{
+    NoiseGenerator noiseGen(seed, backend);
+
+    std::vector<float> xs, ys, zs;
+    GenerateTestPoints(xs, ys, zs);
+
+    std::vector<float> out(TEST_POINT_COUNT);
+    noiseGen.NoiseBatch(xs.data(), ys.data(), zs.data(), out.data(), TEST_POINT_COUNT, simd);
+
+    for (size_t i = 0; i < TEST_POINT_COUNT; ++i)
+    {
+        double reference = noiseGen.Noise<double>(xs[i], ys[i], zs[i]);
+        ASSERT_NEAR(reference, out[i], TEST_TOLERANCE) << "point " << i << " [" << xs[i] << ", "
+                                                       << ys[i] << ", " << zs[i] << "]";
+    }
+}
+
+struct NoiseStats
+{
+    double mean;
+    double deviation;
+    double min;
+    double max;
+};
+
+// Sample noise on a regular grid. 2D noise is used if @p is3D is false.
+NoiseStats GatherStats(const NoiseGenerator& noiseGen, bool is3D)
+{
+    const int size = 64;
+    const double step = 0.173;
+
+    NoiseStats stats = { 0.0, 0.0, 0.0, 0.0 };
+    double sumSquares = 0.0;
+    int count = 0;
+    for (int i = 0; i < size; ++i)
+        for (int j = 0; j < size; ++j)
+            for (int k = 0; k < (is3D ? size : 1); ++k)
+            {
+                double value = is3D ? noiseGen.Noise(i * step, j * step, k * step)
+                                    : noiseGen.Noise2D(i * step, j * step);
+                stats.mean += value;
+                sumSquares += value * value;
+                stats.min = std::min(stats.min, value);
+                stats.max = std::max(stats.max, value);
+                count++;
+            }
+
+    stats.mean /= count;
+    stats.deviation = std::sqrt(sumSquares / count - stats.mean * stats.mean);
+    return stats;
+}
+
+} // namespace
+
+
+/**
+ * Batch evaluation without SIMD should match the scalar reference.
+ */
+TEST(NoiseGenerator, BatchScalar)
+{
+    CheckBatch(NoiseSIMD::Scalar);
+}
+
+/**
+ * SSE 4.1 kernel should match the scalar reference. Falls back to scalar code on older CPUs.
+ */
+TEST(NoiseGenerator, BatchSSE4)
+{
+    CheckBatch(NoiseSIMD::SSE4);
+}
+
+/**
+ * AVX2 kernel should match the scalar reference. Falls back to narrower kernels on older CPUs.
+ */
+TEST(NoiseGenerator, BatchAVX2)
+{
+    CheckBatch(NoiseSIMD::AVX2);
+}
+
+/**
+ * Batches shorter than vector width should be handled entirely by the scalar tail.
+ */
+TEST(NoiseGenerator, BatchShort)
+{
+    NoiseGenerator noiseGen;
+
+    const float xs[] = {0.5f, 1.25f, -3.75f};
+    const float ys[] = {0.5f, 2.5f, 7.125f};
+    const float zs[] = {0.5f, -0.5f, 100.3f};
+    float out[3];
+
+    noiseGen.NoiseBatch(xs, ys, zs, out, 3);
+    for (size_t i = 0; i < 3; ++i)
+        ASSERT_NEAR(noiseGen.Noise<double>(xs[i], ys[i], zs[i]), out[i], TEST_TOLERANCE);
+
+    // Empty batch must not touch anything
+    noiseGen.NoiseBatch(xs, ys, zs, nullptr, 0);
+}
+
+/**
+ * 2D noise should vanish on lattice points and stay within -1..1 range.
+ */
+TEST(NoiseGenerator, Noise2DRange)
+{
+    NoiseGenerator noiseGen;
+
+    ASSERT_EQ(0.0, noiseGen.Noise2D(0.0, 0.0));
+    ASSERT_EQ(0.0, noiseGen.Noise2D(17.0, -42.0));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        double value = noiseGen.Noise2D(i * 0.173, i * -0.091);
+        ASSERT_LE(-1.0, value);
+        ASSERT_GE(1.0, value);
+    }
+}
+
+/**
+ * Tile evaluation should give the same results as evaluating each point separately, also for
+ * tiles wider than a single block of columns.
+ */
+TEST(NoiseGenerator, Noise2DTile)
+{
+    NoiseGenerator noiseGen;
+
+    const size_t width = 70;
+    const size_t height = 5;
+    const double x0 = -3.3;
+    const double y0 = 12.1;
+    const double step = 0.37;
+
+    double tile[width * height];
+    noiseGen.Noise2DTile(x0, y0, step, width, height, tile);
+
+    for (size_t j = 0; j < height; ++j)
+        for (size_t i = 0; i < width; ++i)
+            ASSERT_NEAR(noiseGen.Noise2D(x0 + i * step, y0 + j * step), tile[j * width + i],
+                        TEST_TOLERANCE);
+}
+
+/**
+ * Single octave fBm is plain 2D noise, more octaves should still stay in -1..1 range.
+ */
+TEST(FractalNoise, FBM)
+{
+    NoiseGenerator noiseGen;
+
+    float tile[32 * 32];
+    FractalNoise single;
+    single.GenerateTile(noiseGen, 64.0, -32.0, 32, 32, tile);
+    for (size_t j = 0; j < 32; ++j)
+        for (size_t i = 0; i < 32; ++i)
+            ASSERT_NEAR(noiseGen.Noise2D((64.0 + i) / 32.0, (-32.0 + j) / 32.0),
+                        tile[j * 32 + i], TEST_TOLERANCE);
+
+    FractalDesc desc;
+    desc.octaves = 5;
+    desc.frequency = 1.0 / 64.0;
+    FractalNoise multi(desc);
+    multi.GenerateTile(noiseGen, 64.0, -32.0, 32, 32, tile);
+    for (float value : tile)
+    {
+        ASSERT_LE(-1.0f, value);
+        ASSERT_GE(1.0f, value);
+    }
+}
+
+/**
+ * Ridged noise should stay in -1..1 range and reach its maximum along ridges.
+ */
+TEST(FractalNoise, Ridged)
+{
+    NoiseGenerator noiseGen;
+
+    FractalDesc desc;
+    desc.type = FractalType::Ridged;
+    FractalNoise ridged(desc);
+
+    // Noise vanishes on lattice points, so single octave ridge is at its top there
+    float top;
+    ridged.GenerateTile(noiseGen, 0.0, 0.0, 1, 1, &top);
+    ASSERT_FLOAT_EQ(1.0f, top);
+
+    desc.octaves = 3;
+    ridged = FractalNoise(desc);
+    float tile[32 * 32];
+    ridged.GenerateTile(noiseGen, 100.0, 100.0, 32, 32, tile);
+    for (float value : tile)
+    {
+        ASSERT_LE(-1.0f, value);
+        ASSERT_GE(1.0f, value);
+    }
+}
+
+/**
+ * Noise should depend only on its seed - equal seeds give equal noise, different seeds differ.
+ */
+TEST(NoiseGenerator, Seeds)
+{
+    NoiseGenerator reference;
+    NoiseGenerator first(1234);
+    NoiseGenerator second(1234);
+    NoiseGenerator other(4321);
+
+    ASSERT_EQ(0u, reference.GetSeed());
+    ASSERT_EQ(1234u, first.GetSeed());
+
+    int differences = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        double x = i * 0.37, y = i * 0.11, z = i * -0.53;
+        ASSERT_EQ(first.Noise(x, y, z), second.Noise(x, y, z));
+        if (first.Noise(x, y, z) != other.Noise(x, y, z))
+            differences++;
+    }
+
+    ASSERT_LT(90, differences);
+}
+
+/**
+ * Hash backend kernels should match its scalar reference, just like permutation ones.
+ */
+TEST(NoiseGenerator, HashBatch)
+{
+    CheckBatch(NoiseSIMD::Scalar, NoiseBackend::Hash, 1234);
+    CheckBatch(NoiseSIMD::SSE4, NoiseBackend::Hash, 1234);
+    CheckBatch(NoiseSIMD::AVX2, NoiseBackend::Hash, 1234);
+}
+
+/**
+ * Hash backend tile evaluation should match evaluating each point separately.
+ */
+TEST(NoiseGenerator, HashNoise2DTile)
+{
+    NoiseGenerator noiseGen(1234, NoiseBackend::Hash);
+
+    const size_t width = 7;
+    const size_t height = 5;
+    const double x0 = -3.3;
+    const double y0 = 12.1;
+    const double step = 0.37;
+
+    double tile[width * height];
+    noiseGen.Noise2DTile(x0, y0, step, width, height, tile);
+
+    for (size_t j = 0; j < height; ++j)
+        for (size_t i = 0; i < width; ++i)
+            ASSERT_NEAR(noiseGen.Noise2D(x0 + i * step, y0 + j * step), tile[j * width + i],
+                        TEST_TOLERANCE);
+}
+
+/**
+ * Hash backend should look the same as permutation table - values centered around zero,
+ * with similar spread and range. Exact values are expected to differ.
+ */
+TEST(NoiseGenerator, HashParity)
+{
+    NoiseGenerator permutation;
+    NoiseGenerator hash(0, NoiseBackend::Hash);
+    ASSERT_EQ(NoiseBackend::Hash, hash.GetBackend());
+
+    for (bool is3D : { true, false })
+    {
+        NoiseStats reference = GatherStats(permutation, is3D);
+        NoiseStats stats = GatherStats(hash, is3D);
+
+        ASSERT_NEAR(0.0, stats.mean, 0.05);
+        ASSERT_NEAR(reference.deviation, stats.deviation, reference.deviation * 0.15);
+        ASSERT_LE(-1.0, stats.min);
+        ASSERT_GE(1.0, stats.max);
+        ASSERT_LT(stats.min, -0.5);
+        ASSERT_GT(stats.max, 0.5);
+    }
+
+    // Lattice points still contribute zero
+    ASSERT_EQ(0.0, hash.Noise(3.0, -7.0, 12.0));
+    ASSERT_EQ(0.0, hash.Noise2D(-5.0, 8.0));
+}
+
+/**
+ * Permutation table repeats every 256 units, hash backend does not. Its seed works just like
+ * the permutation one.
+ */
+TEST(NoiseGenerator, HashNoRepeat)
+{
+    NoiseGenerator permutation;
+    NoiseGenerator hash(1234, NoiseBackend::Hash);
+    NoiseGenerator other(4321, NoiseBackend::Hash);
+
+    int repeats = 0;
+    int differences = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        double x = i * 0.37, y = i * 0.11, z = i * -0.53;
+        ASSERT_NEAR(permutation.Noise(x, y, z), permutation.Noise(x + 256.0, y, z), 1e-9);
+        if (hash.Noise(x, y, z) == hash.Noise(x + 256.0, y, z))
+            repeats++;
+        if (hash.Noise(x, y, z) != other.Noise(x, y, z))
+            differences++;
+    }
+
+    ASSERT_GT(10, repeats);
+    ASSERT_LT(90, differences);
+}
+
+/**
+ * Float noise, used for terrain generation, should follow double reference closely enough to
+ * quantize to the same heights almost everywhere.
+ */
+TEST(FractalNoise, Precision)
+{
+    NoiseGenerator noiseGen(1234);
+
+    FractalDesc desc;
+    desc.octaves = 4;
+    desc.frequency = 1.0 / 64.0;
+    FractalNoise fractal(desc);
+
+    const int tileSize = 32;
+    float tile[tileSize * tileSize];
+    double reference[tileSize * tileSize];
+    int columns = 0;
+    int mismatches = 0;
+
+    // Tiles up to 400 chunks away from world center, where float loses more precision
+    const double floatTolerance = 1e-3;
+    for (int tileX = -4; tileX <= 4; ++tileX)
+        for (int tileY = -4; tileY <= 4; ++tileY)
+        {
+            double originX = tileX * 100.0 * tileSize;
+            double originY = tileY * 100.0 * tileSize;
+            fractal.GenerateTile(noiseGen, originX, originY, tileSize, tileSize, tile);
+            fractal.GenerateTile(noiseGen, originX, originY, tileSize, tileSize, reference);
+
+            for (int i = 0; i < tileSize * tileSize; ++i)
+            {
+                ASSERT_NEAR(reference[i], tile[i], floatTolerance);
+                int height = static_cast<int>((tile[i] + 1.0f) * (HEIGHTMAP_HEIGHT / 2));
+                int referenceHeight = static_cast<int>((reference[i] + 1.0) *
+                                                       (HEIGHTMAP_HEIGHT / 2));
+                if (height != referenceHeight)
+                    mismatches++;
+                columns++;
+            }
+        }
+
+    ASSERT_GT(columns / 1000, mismatches);
+}
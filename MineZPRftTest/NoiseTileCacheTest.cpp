@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Noise Tile Cache tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "Terrain/NoiseTileCache.hpp"
+
+
+namespace {
+
+const size_t TEST_TILE_SIZE = 64;
+
+std::vector<float> MakeTile(float value)
+{
+    return std::vector<float>(TEST_TILE_SIZE, value);
+}
+
+NoiseTileKey MakeKey(int x, int z, uint32_t seed = 0)
+{
+    return NoiseTileKey{ x, z, seed, NoiseTileLayer::Heightmap };
+}
+
+} // namespace
+
+
+/**
+ * Stored tile should be returned intact, missing tiles should be reported as misses.
+ */
+TEST(NoiseTileCache, PutGet)
+{
+    NoiseTileCache cache;
+    std::vector<float> out(TEST_TILE_SIZE);
+
+    ASSERT_FALSE(cache.Get(MakeKey(1, 2), out.data(), TEST_TILE_SIZE));
+
+    cache.Put(MakeKey(1, 2), MakeTile(3.0f).data(), TEST_TILE_SIZE);
+    ASSERT_TRUE(cache.Get(MakeKey(1, 2), out.data(), TEST_TILE_SIZE));
+    ASSERT_EQ(MakeTile(3.0f), out);
+
+    // Tiles differing only by seed are separate entries
+    ASSERT_FALSE(cache.Get(MakeKey(1, 2, 7), out.data(), TEST_TILE_SIZE));
+
+    ASSERT_EQ(1u, cache.GetHitCount());
+    ASSERT_EQ(2u, cache.GetMissCount());
+    ASSERT_DOUBLE_EQ(1.0 / 3.0, cache.GetHitRate());
+
+    cache.Clear();
+    ASSERT_EQ(0u, cache.GetSize());
+    ASSERT_EQ(0u, cache.GetHitCount());
+    ASSERT_FALSE(cache.Get(MakeKey(1, 2), out.data(), TEST_TILE_SIZE));
+}
+
+/**
+ * Cache should never exceed its capacity and should evict least recently used tiles first.
+ */
+TEST(NoiseTileCache, Eviction)
+{
+    // Single tile per shard, so eviction order is fully predictable within a shard
+    const size_t capacity = 16;
+    NoiseTileCache cache(capacity);
+    std::vector<float> out(TEST_TILE_SIZE);
+
+    for (int i = 0; i < 1000; ++i)
+        cache.Put(MakeKey(i, -i), MakeTile(static_cast<float>(i)).data(), TEST_TILE_SIZE);
+
+    ASSERT_GE(capacity, cache.GetSize());
+
+    // The most recent tile must still be there, the first ones are long gone
+    ASSERT_TRUE(cache.Get(MakeKey(999, -999), out.data(), TEST_TILE_SIZE));
+    ASSERT_EQ(MakeTile(999.0f), out);
+    ASSERT_FALSE(cache.Get(MakeKey(0, 0), out.data(), TEST_TILE_SIZE));
+}
+
+/**
+ * Recently read tile should survive eviction of older ones.
+ */
+TEST(NoiseTileCache, LeastRecentlyUsed)
+{
+    NoiseTileCache cache(1000);
+    std::vector<float> out(TEST_TILE_SIZE);
+
+    cache.Put(MakeKey(0, 0), MakeTile(1.0f).data(), TEST_TILE_SIZE);
+    for (int i = 1; i < 5000; ++i)
+    {
+        // Keep touching the first tile
+        ASSERT_TRUE(cache.Get(MakeKey(0, 0), out.data(), TEST_TILE_SIZE));
+        cache.Put(MakeKey(i, i), MakeTile(0.0f).data(), TEST_TILE_SIZE);
+    }
+
+    ASSERT_TRUE(cache.Get(MakeKey(0, 0), out.data(), TEST_TILE_SIZE));
+    ASSERT_EQ(MakeTile(1.0f), out);
+}
+
+/**
+ * Cache accessed from many threads at once should stay consistent.
+ */
+TEST(NoiseTileCache, Concurrent)
+{
+    const int threadCount = 8;
+    const int tilesPerThread = 500;
+    NoiseTileCache cache(256);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+        threads.emplace_back([&cache, t]()
+        {
+            std::vector<float> out(TEST_TILE_SIZE);
+            for (int i = 0; i < tilesPerThread; ++i)
+            {
+                // Threads share half of their keys
+                NoiseTileKey key = MakeKey(i, (i % 2) ? t : -1);
+                if (cache.Get(key, out.data(), TEST_TILE_SIZE))
+                    ASSERT_EQ(MakeTile(static_cast<float>(i)), out);
+                else
+                    cache.Put(key, MakeTile(static_cast<float>(i)).data(), TEST_TILE_SIZE);
+            }
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * tilesPerThread),
+              cache.GetHitCount() + cache.GetMissCount());
+    ASSERT_GE(256u, cache.GetSize());
+}
@@ -137,6 +137,34 @@ TEST(TaskQueue, LazyProducer)
     consumerThread.join();
 }
 
+/**
+ * Urgent tasks overtake tasks pushed before them, but keep their own order.
+ */
+TEST(TaskQueue, Urgent)
+{
+    auto lambdaRetParam = [](int i) -> int {
+        return i;
+    };
+
+    TaskQueue<int> queue;
+    queue.Push(std::bind(lambdaRetParam, 1));
+    queue.Push(std::bind(lambdaRetParam, 2));
+    queue.PushUrgent(std::bind(lambdaRetParam, 3));
+    queue.PushUrgent(std::bind(lambdaRetParam, 4));
+
+    ASSERT_EQ(queue.Pop(), 3);
+    ASSERT_EQ(queue.Pop(), 4);
+    ASSERT_EQ(queue.Pop(), 1);
+
+    // Queue is not empty as long as any lane has tasks
+    queue.Clear();
+    ASSERT_TRUE(queue.IsEmpty());
+    queue.PushUrgent(std::bind(lambdaRetParam, 5));
+    ASSERT_FALSE(queue.IsEmpty());
+    ASSERT_EQ(queue.Pop(), 5);
+    ASSERT_TRUE(queue.IsEmpty());
+}
+
 /**
  * Check if destroying a queue will not cause a hang.
  */
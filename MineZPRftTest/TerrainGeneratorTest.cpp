@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Terrain Generator tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "Terrain/TerrainGenerator.hpp"
+
+
+namespace {
+
+const int TEST_CHUNK_RADIUS = 2;
+
+size_t VoxelIndex(int x, int y, int z)
+{
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+std::vector<VoxelType> GenerateChunk(const TerrainGeneratorDesc& desc, int x, int z)
+{
+    TerrainGenerator generator;
+    generator.Init(desc);
+
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+    generator.Generate(voxels.data(), x, z);
+    return voxels;
+}
+
+} // namespace
+
+
+/**
+ * Generation should be deterministic - the same chunk generated twice must not differ.
+ */
+TEST(TerrainGenerator, Deterministic)
+{
+    TerrainGeneratorDesc desc;
+    desc.caves = true;
+
+    ASSERT_EQ(GenerateChunk(desc, 3, -4), GenerateChunk(desc, 3, -4));
+}
+
+/**
+ * Caves should only remove stone, leaving bedrock and air untouched.
+ */
+TEST(TerrainGenerator, CavesOnlyCarve)
+{
+    TerrainGeneratorDesc desc;
+    TerrainGeneratorDesc cavesDesc;
+    cavesDesc.caves = true;
+
+    size_t carved = 0;
+    for (int chunkX = -TEST_CHUNK_RADIUS; chunkX <= TEST_CHUNK_RADIUS; ++chunkX)
+        for (int chunkZ = -TEST_CHUNK_RADIUS; chunkZ <= TEST_CHUNK_RADIUS; ++chunkZ)
+        {
+            std::vector<VoxelType> solid = GenerateChunk(desc, chunkX, chunkZ);
+            std::vector<VoxelType> caves = GenerateChunk(cavesDesc, chunkX, chunkZ);
+
+            for (size_t i = 0; i < CHUNK_VOXEL_COUNT; ++i)
+            {
+                if (solid[i] == caves[i])
+                    continue;
+
+                ASSERT_EQ(VoxelType::Stone, solid[i]);
+                ASSERT_EQ(VoxelType::Air, caves[i]);
+                carved++;
+            }
+
+            for (int x = 0; x < CHUNK_X; ++x)
+                for (int z = 0; z < CHUNK_Z; ++z)
+                {
+                    ASSERT_EQ(VoxelType::Bedrock, caves[VoxelIndex(x, 0, z)]);
+                    ASSERT_EQ(VoxelType::Bedrock, caves[VoxelIndex(x, 1, z)]);
+                }
+        }
+
+    // With some chunks generated, at least a few caves must have appeared
+    ASSERT_LT(0u, carved);
+}
+
+/**
+ * Worlds with different seeds should be generated independently, also at the same time.
+ */
+TEST(TerrainGenerator, ParallelSeeds)
+{
+    const uint32_t seeds[] = { 0, 1, 2, 3 };
+    const size_t seedCount = sizeof(seeds) / sizeof(seeds[0]);
+
+    std::vector<std::vector<VoxelType>> serial(seedCount);
+    for (size_t i = 0; i < seedCount; ++i)
+    {
+        TerrainGeneratorDesc desc;
+        desc.seed = seeds[i];
+        desc.caves = true;
+        serial[i] = GenerateChunk(desc, 5, 7);
+    }
+
+    std::vector<std::vector<VoxelType>> parallel(seedCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seedCount; ++i)
+        threads.emplace_back([&parallel, &seeds, i]()
+        {
+            TerrainGeneratorDesc desc;
+            desc.seed = seeds[i];
+            desc.caves = true;
+            parallel[i] = GenerateChunk(desc, 5, 7);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < seedCount; ++i)
+        ASSERT_EQ(serial[i], parallel[i]);
+
+    ASSERT_NE(serial[0], serial[1]);
+}
+
+/**
+ * Interpolated climate should change smoothly, also across chunk borders.
+ */
+TEST(TerrainGenerator, ClimateSeamless)
+{
+    TerrainGenerator generator;
+    generator.Init(TerrainGeneratorDesc());
+
+    ChunkClimate climate[2];
+    generator.GetClimate(3, -2, climate[0]);
+    generator.GetClimate(4, -2, climate[1]);
+
+    // One column apart, climate noise changes by a tiny fraction of its range
+    const float maxStep = 0.05f;
+    auto checkStep = [&](int first, int firstChunk, int second, int secondChunk)
+    {
+        const ChunkClimate& a = climate[firstChunk];
+        const ChunkClimate& b = climate[secondChunk];
+        ASSERT_NEAR(a.temperature[first], b.temperature[second], maxStep);
+        ASSERT_NEAR(a.humidity[first], b.humidity[second], maxStep);
+        ASSERT_NEAR(a.heightScale[first], b.heightScale[second], maxStep * 5.0f);
+        ASSERT_NEAR(a.heightOffset[first], b.heightOffset[second], maxStep * 5.0f);
+    };
+
+    for (int z = 0; z < CHUNK_Z; ++z)
+    {
+        for (int x = 1; x < CHUNK_X; ++x)
+            checkStep((x - 1) * CHUNK_Z + z, 0, x * CHUNK_Z + z, 0);
+
+        checkStep((CHUNK_X - 1) * CHUNK_Z + z, 0, z, 1);
+    }
+
+    // Temperature and humidity are independent fields
+    ASSERT_NE(climate[0].temperature[0], climate[0].humidity[0]);
+}
+
+/**
+ * Biome height profiles should blend smoothly, without cliffs on biome borders.
+ */
+TEST(TerrainGenerator, BiomeBlending)
+{
+    const float epsilon = 1e-4f;
+    const float climates[] = { -0.5f, 0.5f };
+
+    for (float other : climates)
+    {
+        BiomeDesc cold = EvaluateClimate(-epsilon, other);
+        BiomeDesc hot = EvaluateClimate(epsilon, other);
+        ASSERT_NE(SelectBiome(-epsilon, other), SelectBiome(epsilon, other));
+        ASSERT_NEAR(cold.heightScale, hot.heightScale, 0.01f);
+        ASSERT_NEAR(cold.heightOffset, hot.heightOffset, 0.01f);
+
+        BiomeDesc dry = EvaluateClimate(other, -epsilon);
+        BiomeDesc humid = EvaluateClimate(other, epsilon);
+        ASSERT_NE(SelectBiome(other, -epsilon), SelectBiome(other, epsilon));
+        ASSERT_NEAR(dry.heightScale, humid.heightScale, 0.01f);
+        ASSERT_NEAR(dry.heightOffset, humid.heightOffset, 0.01f);
+    }
+}
+
+/**
+ * With biomes enabled, every column should be covered with surface voxel of its biome.
+ */
+TEST(TerrainGenerator, BiomeSurface)
+{
+    TerrainGeneratorDesc desc;
+    desc.biomes = true;
+    TerrainGenerator generator;
+    generator.Init(desc);
+
+    ChunkClimate climate;
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT);
+
+    for (int chunkX = -TEST_CHUNK_RADIUS; chunkX <= TEST_CHUNK_RADIUS; ++chunkX)
+        for (int chunkZ = -TEST_CHUNK_RADIUS; chunkZ <= TEST_CHUNK_RADIUS; ++chunkZ)
+        {
+            generator.Generate(voxels.data(), chunkX, chunkZ);
+            generator.GetClimate(chunkX, chunkZ, climate);
+
+            for (int x = 0; x < CHUNK_X; ++x)
+                for (int z = 0; z < CHUNK_Z; ++z)
+                {
+                    int top = CHUNK_Y - 1;
+                    while (top > 0 && voxels[VoxelIndex(x, top, z)] == VoxelType::Air)
+                        top--;
+
+                    int i = x * CHUNK_Z + z;
+                    const BiomeDesc& biome = GetBiomeDesc(SelectBiome(climate.temperature[i],
+                                                                      climate.humidity[i]));
+                    ASSERT_EQ(biome.surface, voxels[VoxelIndex(x, top, z)]);
+                    ASSERT_EQ(biome.subsurface, voxels[VoxelIndex(x, top - 1, z)]);
+                    ASSERT_EQ(VoxelType::Bedrock, voxels[VoxelIndex(x, 0, z)]);
+                }
+        }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @author agent (agent@local)
+ * @brief  Voxel fill tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Terrain/VoxelFill.hpp"
+
+
+namespace {
+
+size_t VoxelIndex(int x, int y, int z)
+{
+    return x * CHUNK_Y * CHUNK_Z + y * CHUNK_Z + z;
+}
+
+// Count voxels of given type, and check if all of them are inside the box
+bool CheckBox(const std::vector<VoxelType>& voxels, int x0, int y0, int z0, int x1, int y1, int z1,
+              VoxelType voxel)
+{
+    for (int x = 0; x < CHUNK_X; ++x)
+        for (int y = 0; y < CHUNK_Y; ++y)
+            for (int z = 0; z < CHUNK_Z; ++z)
+            {
+                bool inside = x >= x0 && x < x1 && y >= y0 && y < y1 && z >= z0 && z < z1;
+                bool filled = voxels[VoxelIndex(x, y, z)] == voxel;
+                if (inside != filled)
+                    return false;
+            }
+
+    return true;
+}
+
+} // namespace
+
+
+/**
+ * Column fill should touch only the given span of a single column.
+ */
+TEST(VoxelFill, Column)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+
+    FillColumn(voxels.data(), 3, 30, 5, 77, VoxelType::Stone);
+    ASSERT_TRUE(CheckBox(voxels, 3, 5, 30, 4, 77, 31, VoxelType::Stone));
+
+    // Empty span
+    FillColumn(voxels.data(), 0, 0, 10, 10, VoxelType::Stone);
+    ASSERT_EQ(VoxelType::Air, voxels[VoxelIndex(0, 10, 0)]);
+}
+
+/**
+ * Layer fill should cover whole chunk area between given heights.
+ */
+TEST(VoxelFill, Layer)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+
+    FillLayer(voxels.data(), 0, 2, VoxelType::Bedrock);
+    ASSERT_TRUE(CheckBox(voxels, 0, 0, 0, CHUNK_X, 2, CHUNK_Z, VoxelType::Bedrock));
+
+    FillLayer(voxels.data(), 0, CHUNK_Y, VoxelType::Stone);
+    ASSERT_TRUE(CheckBox(voxels, 0, 0, 0, CHUNK_X, CHUNK_Y, CHUNK_Z, VoxelType::Stone));
+}
+
+/**
+ * Box fill should work for partial and full Z ranges.
+ */
+TEST(VoxelFill, Box)
+{
+    std::vector<VoxelType> voxels(CHUNK_VOXEL_COUNT, VoxelType::Air);
+
+    FillBox(voxels.data(), 2, 10, 7, 9, 20, 13, VoxelType::Stone);
+    ASSERT_TRUE(CheckBox(voxels, 2, 10, 7, 9, 20, 13, VoxelType::Stone));
+
+    FillBox(voxels.data(), 0, 0, 0, CHUNK_X, CHUNK_Y, CHUNK_Z, VoxelType::Air);
+    FillBox(voxels.data(), 5, 40, 0, 6, 41, CHUNK_Z, VoxelType::Bedrock);
+    ASSERT_TRUE(CheckBox(voxels, 5, 40, 0, 6, 41, CHUNK_Z, VoxelType::Bedrock));
+
+    // Empty boxes must not write anything
+    FillBox(voxels.data(), 5, 40, 0, 5, 41, CHUNK_Z, VoxelType::Stone);
+    FillBox(voxels.data(), 5, 40, 3, 6, 41, 3, VoxelType::Stone);
+    ASSERT_TRUE(CheckBox(voxels, 0, 0, 0, 0, 0, 0, VoxelType::Stone));
+}